@@ -4,6 +4,7 @@
 
 #include <cassert>
 
+#include "../ecs/command/command.h"
 #include "../ecs/entity/entity.h"
 #include "../ecs/system/system.h"
 #include "../event/event.h"
@@ -48,6 +49,10 @@ Application::Application(const std::string& title, int width, int height,
         exit(EXIT_FAILURE);
     }
 
+    // managers worker threads post to, created before any of them starts
+    EventManager::Get();
+    EventBus::Get();
+
     instance = this;
 
     Logger::info("App") << "Application created";
@@ -85,6 +90,10 @@ void Application::run() {
         EventManager::Get()->handle();
         SystemManager::Get()->run();
 
+        // structural changes requested by systems and by the previous
+        // scripts update, applied before the active scene may be replaced
+        CommandBuffer::Flush();
+
         auto sceneManager = SceneManager::Get();
         if (!sceneManager->update())
             quit();  // No more scene left
@@ -10,11 +10,14 @@
 #include "./application/application.h"
 #include "./application/hook.h"
 #include "./ecs/ecs.h"
+#include "./event/bus.h"
 #include "./event/event.h"
 #include "./event/input.h"
+#include "./job/job.h"
 #include "./renderer/renderer.h"
 #include "./scene/scene.h"
 #include "./serializer/serializer.h"
+#include "./texture/atlas.h"
 #include "./texture/texture.h"
 #include "./util/util.h"
 
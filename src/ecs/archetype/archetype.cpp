@@ -0,0 +1,206 @@
+#include "archetype.h"
+
+#include <cassert>
+#include <cstddef>
+
+namespace {
+
+std::size_t alignUp(std::size_t offset, std::size_t align) {
+    return (offset + align - 1) / align * align;
+}
+
+}  // namespace
+
+Archetype::Archetype(const Signature& signature,
+                     const std::vector<ComponentInfo>& infos)
+    : _signature(signature), _infos(infos) {
+    std::size_t rowBytes = sizeof(EntityID);
+    for (std::size_t type = 0; type < signature.size(); ++type) {
+        if (!signature[type]) continue;
+
+        assert(infos[type].align <= alignof(std::max_align_t) &&
+               "Over-aligned components are not supported");
+
+        _types.push_back(ComponentTypeID(type));
+        rowBytes += infos[type].size;
+    }
+
+    addEdges.resize(MAX_COMPONENTS, nullptr);
+    removeEdges.resize(MAX_COMPONENTS, nullptr);
+    _offsets.resize(_types.empty() ? 0 : _types.back() + 1, 0);
+
+    // fit as many rows as possible in a chunk, padding included
+    _capacity = std::max<std::size_t>(1, CHUNK_BYTES / rowBytes);
+    while (true) {
+        auto offset = sizeof(EntityID) * _capacity;
+        for (auto type : _types) {
+            offset = alignUp(offset, _infos[type].align);
+            _offsets[type] = offset;
+            offset += _infos[type].size * _capacity;
+        }
+
+        if (offset <= CHUNK_BYTES || _capacity == 1) {
+            _chunkBytes = std::max(offset, CHUNK_BYTES);
+            break;
+        }
+        --_capacity;
+    }
+}
+
+Archetype::~Archetype() {
+    for (std::size_t row = 0; row < _size; ++row)
+        for (auto type : _types) _infos[type].destroy(get(row, type));
+}
+
+void Archetype::_newChunk() {
+    Chunk chunk;
+    chunk.data.reset(new std::byte[_chunkBytes]);
+    chunk.entities = reinterpret_cast<EntityID*>(chunk.data.get());
+    _chunks.push_back(std::move(chunk));
+}
+
+std::size_t Archetype::add(EntityID entity) {
+    if (_size == _chunks.size() * _capacity) _newChunk();
+
+    auto row = _size++;
+    auto& chunk = _chunks[row / _capacity];
+    chunk.entities[chunk.count++] = entity;
+
+    return row;
+}
+
+EntityID Archetype::remove(std::size_t row) {
+    auto last = _size - 1;
+
+    for (auto type : _types) {
+        auto& info = _infos[type];
+        auto dst = get(row, type);
+        info.destroy(dst);
+
+        if (row != last) {
+            auto src = get(last, type);
+            info.move(dst, src);
+            info.destroy(src);
+        }
+    }
+
+    auto& lastChunk = _chunks[last / _capacity];
+    auto moved = NULL_ENTITY;
+    if (row != last) {
+        moved = lastChunk.entities[last % _capacity];
+        _chunks[row / _capacity].entities[row % _capacity] = moved;
+    }
+
+    --lastChunk.count;
+    --_size;
+
+    // keep one spare chunk to avoid thrashing at chunk boundaries
+    while (_chunks.size() > 1 && _chunks.back().count == 0 &&
+           _chunks[_chunks.size() - 2].count == 0)
+        _chunks.pop_back();
+
+    return moved;
+}
+
+ArchetypeRegistry::Record& ArchetypeRegistry::_record(EntityID entity) {
+    auto index = entityIndex(entity);
+    if (index >= _records.size()) {
+        _records.resize(index + 1);
+        _owners.resize(index + 1, NULL_ENTITY);
+    }
+
+    // slot previously used by a destroyed entity
+    if (_owners[index] != entity) {
+        _owners[index] = entity;
+        _records[index] = Record();
+    }
+
+    return _records[index];
+}
+
+Archetype* ArchetypeRegistry::_archetype(const Signature& signature) {
+    if (signature.none()) return nullptr;
+
+    auto it = _bySignature.find(signature);
+    if (it != _bySignature.end()) return it->second;
+
+    _archetypes.push_back(std::make_unique<Archetype>(signature, _infos));
+    auto archetype = _archetypes.back().get();
+    _bySignature[signature] = archetype;
+
+    return archetype;
+}
+
+Archetype* ArchetypeRegistry::_addEdge(Archetype* from, ComponentTypeID type) {
+    if (!from) {
+        Signature signature;
+        signature.set(type);
+        return _archetype(signature);
+    }
+
+    auto& edge = from->addEdges[type];
+    if (!edge) {
+        auto signature = from->signature();
+        signature.set(type);
+        edge = _archetype(signature);
+    }
+    return edge;
+}
+
+Archetype* ArchetypeRegistry::_removeEdge(Archetype* from,
+                                         ComponentTypeID type) {
+    auto& edge = from->removeEdges[type];
+    if (!edge) {
+        auto signature = from->signature();
+        signature.reset(type);
+        edge = _archetype(signature);
+    }
+    return edge;
+}
+
+void ArchetypeRegistry::_move(EntityID entity, Record& record,
+                             Archetype* target) {
+    auto source = record.archetype;
+    if (source == target) return;
+
+    std::size_t row = 0;
+    if (target) {
+        row = target->add(entity);
+        if (source)
+            for (auto type : source->types())
+                if (target->signature()[type])
+                    _infos[type].move(target->get(row, type),
+                                      source->get(record.row, type));
+    }
+
+    if (source) {
+        auto moved = source->remove(record.row);
+        if (moved != NULL_ENTITY) _records[entityIndex(moved)].row = record.row;
+    }
+
+    record.archetype = target;
+    record.row = row;
+}
+
+void ArchetypeRegistry::remove(EntityID entity, ComponentTypeID type) {
+    auto record = find(entity);
+    if (!record || !record->archetype->signature()[type]) return;
+
+    _move(entity, *record, _removeEdge(record->archetype, type));
+}
+
+void ArchetypeRegistry::entityDestroyed(EntityID entity) {
+    auto record = find(entity);
+    if (!record) return;
+
+    _move(entity, *record, nullptr);
+    _owners[entityIndex(entity)] = NULL_ENTITY;
+}
+
+std::size_t ArchetypeRegistry::count(const Signature& signature) const {
+    std::size_t ret = 0;
+    for (auto& archetype : _archetypes)
+        if ((archetype->signature() & signature) == signature)
+            ret += archetype->size();
+    return ret;
+}
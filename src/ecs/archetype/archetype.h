@@ -0,0 +1,203 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Archetype storage : entities sharing the same set of components are
+ * stored together, one column per component type.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../defs.h"
+
+// Type-erased operations needed to move components between archetypes
+struct ComponentInfo {
+    std::size_t size = 0;
+    std::size_t align = 0;
+    void (*move)(void* dst, void* src) = nullptr;  // move-construct
+    void (*destroy)(void*) = nullptr;
+
+    template <typename T>
+    static ComponentInfo of() {
+        ComponentInfo info;
+        info.size = sizeof(T);
+        info.align = alignof(T);
+        info.move = [](void* dst, void* src) {
+            new (dst) T(std::move(*static_cast<T*>(src)));
+        };
+        info.destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+        return info;
+    }
+};
+
+/**
+ * Table of entities with the same signature
+ *
+ * Rows are stored in fixed size chunks. Inside a chunk, each component type
+ * has its own contiguous column (SoA), so walking a chunk is a linear scan.
+ */
+class Archetype {
+   public:
+    // bytes allocated per chunk
+    static constexpr std::size_t CHUNK_BYTES = 16 * 1024;
+
+    struct Chunk {
+        std::unique_ptr<std::byte[]> data;
+        EntityID* entities = nullptr;
+        std::size_t count = 0;
+    };
+
+    Archetype(const Signature&, const std::vector<ComponentInfo>&);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    const Signature& signature() const { return _signature; }
+
+    // number of entities stored
+    std::size_t size() const { return _size; }
+
+    // append a row with uninitialized components, return the row index
+    std::size_t add(EntityID);
+
+    /**
+     * Destroy components of the row and move the last row into it
+     * @return entity moved into the row, NULL_ENTITY if none
+     */
+    EntityID remove(std::size_t row);
+
+    // address of the component in the given row
+    void* get(std::size_t row, ComponentTypeID type) {
+        auto& chunk = _chunks[row / _capacity];
+        return column(chunk, type) + (row % _capacity) * _infos[type].size;
+    }
+
+    // start of a component column inside a chunk
+    std::byte* column(const Chunk& chunk, ComponentTypeID type) {
+        return chunk.data.get() + _offsets[type];
+    }
+
+    std::vector<Chunk>& chunks() { return _chunks; }
+
+    // component types held, in increasing ID order
+    const std::vector<ComponentTypeID>& types() const { return _types; }
+
+    // cached transitions when adding or removing one component
+    std::vector<Archetype*> addEdges;
+    std::vector<Archetype*> removeEdges;
+
+   private:
+    void _newChunk();
+
+    Signature _signature;
+    std::vector<ComponentTypeID> _types;
+
+    // indexed by component type ID
+    const std::vector<ComponentInfo>& _infos;
+    std::vector<std::size_t> _offsets;
+
+    // rows per chunk
+    std::size_t _capacity = 1;
+    std::size_t _chunkBytes = CHUNK_BYTES;
+    std::size_t _size = 0;
+    std::vector<Chunk> _chunks;
+};
+
+/**
+ * Archetype based backend of the component manager
+ *
+ * Holds components whose ComponentTraits select archetype storage. Adding or
+ * removing such a component moves the entity, with all of its archetype
+ * stored components, to the table matching its new signature : references
+ * to these components are invalidated by attach/distach on the same entity.
+ */
+class ArchetypeRegistry {
+   public:
+    struct Record {
+        Archetype* archetype = nullptr;
+        std::size_t row = 0;
+    };
+
+    template <typename T>
+    void registerType(ComponentTypeID type) {
+        if (type >= _infos.size()) _infos.resize(type + 1);
+        if (!_infos[type].size) _infos[type] = ComponentInfo::of<T>();
+    }
+
+    template <typename T, typename... TArgs>
+    T& emplace(EntityID entity, ComponentTypeID type, TArgs&&... args) {
+        registerType<T>(type);
+
+        // build first, arguments may refer to components about to move
+        T value(std::forward<TArgs>(args)...);
+
+        auto& record = _record(entity);
+        auto target = _addEdge(record.archetype, type);
+        _move(entity, record, target);
+
+        auto ptr = target->get(record.row, type);
+        return *new (ptr) T(std::move(value));
+    }
+
+    void remove(EntityID, ComponentTypeID);
+
+    template <typename T>
+    T* get(EntityID entity, ComponentTypeID type) {
+        auto record = find(entity);
+        if (!record || !record->archetype->signature()[type]) return nullptr;
+        return static_cast<T*>(record->archetype->get(record->row, type));
+    }
+
+    // record of the entity, null if it has no archetype stored component
+    Record* find(EntityID entity) {
+        auto index = entityIndex(entity);
+        if (index >= _records.size() || _owners[index] != entity ||
+            !_records[index].archetype)
+            return nullptr;
+        return &_records[index];
+    }
+
+    void entityDestroyed(EntityID);
+
+    // number of entities holding every component of the signature
+    std::size_t count(const Signature&) const;
+
+    /**
+     * Walk tables containing every component of the signature
+     * process(Archetype&, Archetype::Chunk&) is called once per chunk
+     */
+    template <typename F>
+    void eachChunk(const Signature& signature, F&& process) {
+        for (auto& archetype : _archetypes) {
+            if ((archetype->signature() & signature) != signature) continue;
+            for (auto& chunk : archetype->chunks())
+                if (chunk.count) process(*archetype, chunk);
+        }
+    }
+
+   private:
+    Record& _record(EntityID);
+    Archetype* _addEdge(Archetype*, ComponentTypeID);
+    Archetype* _removeEdge(Archetype*, ComponentTypeID);
+    Archetype* _archetype(const Signature&);
+
+    // move entity components from its current table to target
+    void _move(EntityID, Record&, Archetype* target);
+
+    std::vector<ComponentInfo> _infos;
+
+    // tables in creation order, looked up by signature
+    std::vector<std::unique_ptr<Archetype>> _archetypes;
+    std::unordered_map<Signature, Archetype*> _bySignature;
+
+    // indexed by entity slot
+    std::vector<Record> _records;
+    std::vector<EntityID> _owners;
+};
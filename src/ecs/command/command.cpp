@@ -0,0 +1,174 @@
+#include "command.h"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
+#include "../../logger/logger.h"
+#include "../components.h"
+#include "../group/group.h"
+
+std::mutex CommandBuffer::_buffersMutex;
+std::vector<std::unique_ptr<CommandBuffer>> CommandBuffer::_buffers;
+thread_local CommandBuffer::Owner CommandBuffer::_current;
+
+CommandBuffer::Owner::~Owner() {
+    if (!buffer) return;
+
+    // pending commands are still applied by the next flush
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    buffer->_released = true;
+}
+
+// static
+CommandBuffer& CommandBuffer::Get() {
+    if (!_current.buffer) {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        _buffers.emplace_back(new CommandBuffer);
+        _current.buffer = _buffers.back().get();
+    }
+    return *_current.buffer;
+}
+
+CommandBuffer::PendingEntity CommandBuffer::create(Group& group) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _commands[_side].push_back({Command::CREATE, NULL_ENTITY, _created, &group,
+                                nullptr, nullptr, nullptr});
+    return {_created++, _epoch, this};
+}
+
+CommandBuffer::PendingEntity CommandBuffer::create(Group& group,
+                                                   const std::string& tag) {
+    auto ret = create(group);
+    attach<Component::tag>(ret, tag);
+    return ret;
+}
+
+void CommandBuffer::destroy(EntityID entity) {
+    _record({Command::DESTROY, entity, NPOS, nullptr, nullptr, nullptr,
+             nullptr});
+}
+
+std::size_t CommandBuffer::size() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _commands[_side].size();
+}
+
+void CommandBuffer::_record(Command&& command) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _commands[_side].push_back(std::move(command));
+}
+
+bool CommandBuffer::_valid(const PendingEntity& entity) {
+    // indices are local to the buffer, they would designate another entity
+    assert(entity.owner == this &&
+           "Pending entity used with the buffer of another thread");
+    if (entity.owner != this) {
+        Logger::warn("CommandBuffer")
+            << "Pending entity of another buffer, command ignored";
+        Logger::endline();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (entity.epoch == _epoch && entity.index < _created) return true;
+
+    Logger::warn("CommandBuffer")
+        << "Pending entity used after a flush, command ignored";
+    Logger::endline();
+    return false;
+}
+
+// static
+void CommandBuffer::Flush() {
+    // commands and arguments taken from a buffer
+    struct Batch {
+        std::vector<Command>* commands;
+        Arena* arguments;
+    };
+
+    std::vector<Batch> batches;
+    {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        for (auto& buffer : _buffers) {
+            std::lock_guard<std::mutex> guard(buffer->_mutex);
+            auto side = buffer->_side;
+            if (buffer->_commands[side].empty()) continue;
+
+            // record on the other side while this one is applied
+            batches.push_back(
+                {&buffer->_commands[side], &buffer->_arenas[side]});
+            buffer->_side = 1 - side;
+            buffer->_created = 0;
+            ++buffer->_epoch;
+        }
+    }
+
+    // grow each component array once for the whole frame
+    std::unordered_map<void (*)(std::size_t), std::size_t> attached;
+    for (auto& batch : batches)
+        for (auto& command : *batch.commands)
+            if (command.kind == Command::ATTACH) ++attached[command.reserve];
+
+    for (auto& [reserve, count] : attached) reserve(count);
+
+    // storage is kept for the next frame
+    for (auto& batch : batches) {
+        _apply(*batch.commands);
+        batch.commands->clear();
+        batch.arguments->reset();
+    }
+
+    // free buffers of exited threads, e.g. after the job system shrinks
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    _buffers.erase(
+        std::remove_if(_buffers.begin(), _buffers.end(),
+                       [](const std::unique_ptr<CommandBuffer>& buffer) {
+                           return buffer->_released &&
+                                  buffer->_commands[0].empty() &&
+                                  buffer->_commands[1].empty();
+                       }),
+        _buffers.end());
+}
+
+// static
+void CommandBuffer::_apply(std::vector<Command>& commands) {
+    std::vector<EntityID> created;
+
+    for (auto& command : commands) {
+        if (command.kind == Command::CREATE) {
+            created.push_back(command.group->create().id());
+            continue;
+        }
+
+        if (command.created != NPOS && command.created >= created.size())
+            continue;
+
+        auto id = command.created == NPOS ? command.entity
+                                          : created[command.created];
+
+        switch (command.kind) {
+
+            case Command::DESTROY: {
+                // may have been destroyed more than once this frame
+                if (!Entity::Alive(id)) break;
+
+                auto entity = Entity::Get(id);
+                if (entity->has<Component::group>())
+                    entity->get<Component::group>().content->erase(id);
+                else
+                    delete entity;
+                break;
+            }
+
+            case Command::ATTACH:
+            case Command::DISTACH:
+                if (auto entity = Entity::Get(id); entity)
+                    command.apply(*entity, command.arguments);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
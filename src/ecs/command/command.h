@@ -0,0 +1,180 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Deferred structural changes of the ECS
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../util/memory/arena.h"
+#include "../component/manager.h"
+#include "../defs.h"
+#include "../entity/entity.h"
+
+class Group;
+
+/**
+ * Records entity creation/destruction and component attach/distach, applied
+ * later by CommandBuffer::Flush (once per frame by the application).
+ * Each thread records into its own buffer, so systems running on workers
+ * and scripts iterating a group can request structural changes safely.
+ *
+ * auto& commands = CommandBuffer::Get();
+ * auto bullet = commands.create(group);
+ * commands.attach<Component::transform>(bullet, position, scale, 0.0);
+ * commands.destroy(entity.id());
+ */
+class CommandBuffer {
+   public:
+    // entity created by a buffer on flush, only valid with that buffer
+    // until the next flush
+    struct PendingEntity {
+        std::size_t index;
+        std::uint32_t epoch;
+
+        // buffer which returned it
+        const CommandBuffer* owner;
+    };
+
+    // buffer of the calling thread
+    static CommandBuffer& Get();
+
+    /**
+     * Apply commands of every buffer, in recording order for each thread.
+     * Must be called from the main thread while no thread is recording.
+     * Commands recorded while flushing are applied on the next flush.
+     * Buffers of exited threads are freed once their commands are applied.
+     */
+    static void Flush();
+
+    // create an entity in the group
+    PendingEntity create(Group&);
+
+    // create an entity in the group and attach a tag component to it
+    PendingEntity create(Group&, const std::string& tag);
+
+    void destroy(EntityID);
+
+    template <typename T, typename... TArgs>
+    void attach(EntityID entity, TArgs&&... args) {
+        _attach<T>(entity, NPOS, std::forward<TArgs>(args)...);
+    }
+
+    template <typename T, typename... TArgs>
+    void attach(PendingEntity entity, TArgs&&... args) {
+        if (!_valid(entity)) return;
+        _attach<T>(NULL_ENTITY, entity.index, std::forward<TArgs>(args)...);
+    }
+
+    template <typename T>
+    void distach(EntityID entity) {
+        _record({Command::DISTACH, entity, NPOS, nullptr, &_distach<T>,
+                 nullptr, nullptr});
+    }
+
+    template <typename T>
+    void distach(PendingEntity entity) {
+        if (!_valid(entity)) return;
+        _record({Command::DISTACH, NULL_ENTITY, entity.index, nullptr,
+                 &_distach<T>, nullptr, nullptr});
+    }
+
+    // number of recorded commands
+    std::size_t size();
+
+   private:
+    static constexpr std::size_t NPOS = ~std::size_t(0);
+
+    struct Command {
+        enum Kind { CREATE, DESTROY, ATTACH, DISTACH } kind;
+
+        EntityID entity;
+
+        // index of an entity created by this buffer, NPOS for existing ones
+        std::size_t created;
+
+        Group* group;
+
+        void (*apply)(Entity&, void* arguments);
+
+        // attach arguments, stored in the buffer arena
+        void* arguments;
+
+        // make room for components of the attached type
+        void (*reserve)(std::size_t);
+    };
+
+    template <typename T>
+    static void _distach(Entity& e, void*) {
+        e.distach<T>();
+    }
+
+    template <typename T, typename Arguments>
+    static void _attachFrom(Entity& e, void* arguments) {
+        std::apply([&](auto&... a) { e.attach<T>(std::move(a)...); },
+                   *static_cast<Arguments*>(arguments));
+    }
+
+    template <typename T>
+    static void _reserve(std::size_t count) {
+        ComponentManager::Get().reserve<T>(count);
+    }
+
+    template <typename T, typename... TArgs>
+    void _attach(EntityID entity, std::size_t created, TArgs&&... args) {
+        using Arguments = std::tuple<std::decay_t<TArgs>...>;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // arguments are copied until the command is applied, no allocation
+        // once the arena has grown to a frame worth of commands
+        auto arguments = _arenas[_side].create<Arguments>(
+            std::forward<TArgs>(args)...);
+        _commands[_side].push_back({Command::ATTACH, entity, created, nullptr,
+                                    &_attachFrom<T, Arguments>, arguments,
+                                    &_reserve<T>});
+    }
+
+    void _record(Command&&);
+
+    // check that a pending entity was returned since the last flush
+    bool _valid(const PendingEntity&);
+
+    // apply commands taken from a buffer
+    static void _apply(std::vector<Command>&);
+
+    std::mutex _mutex;
+
+    // recording goes to one side while the other one is being flushed
+    std::vector<Command> _commands[2];
+    Arena _arenas[2];
+    int _side = 0;
+
+    std::size_t _created = 0;
+
+    // incremented on each flush, invalidates pending entities
+    std::uint32_t _epoch = 0;
+
+    // the recording thread exited, guarded by _buffersMutex
+    bool _released = false;
+
+    // buffer of a thread, released when the thread exits
+    struct Owner {
+        CommandBuffer* buffer = nullptr;
+        ~Owner();
+    };
+
+    static std::mutex _buffersMutex;
+    static std::vector<std::unique_ptr<CommandBuffer>> _buffers;
+    static thread_local Owner _current;
+};
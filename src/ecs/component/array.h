@@ -6,91 +6,191 @@
 
 #pragma once
 
-#include <array>
 #include <cassert>
 #include <functional>
 #include <iostream>
-#include <unordered_map>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "../../logger/logger.h"
+#include "../../util/memory/pool.h"
 #include "../defs.h"
+#include "sparse.h"
+
+// Storage policies, inherit from one of them to specialize ComponentTraits
+
+// stored by value in the packed array of the component type
+struct PackedStorage {
+    static constexpr bool stable = false;
+    static constexpr bool archetype = false;
+};
+
+// stored on the heap, the address never changes
+struct StableStorage {
+    static constexpr bool stable = true;
+    static constexpr bool archetype = false;
+};
+
+// stored by value in the table of the entity archetype
+struct ArchetypeStorage {
+    static constexpr bool stable = false;
+    static constexpr bool archetype = true;
+};
+
+#ifdef ECS_ARCHETYPE_STORAGE
+using DefaultStorage = ArchetypeStorage;
+#else
+using DefaultStorage = PackedStorage;
+#endif
+
+/**
+ * Storage policy of a component type.
+ *
+ * Polymorphic components (scripts, cameras) are referenced by address from
+ * outside of their array, so each of them keeps its own heap slot.
+ * Any other component lives by value, either in the packed array of its
+ * type or, when ECS_ARCHETYPE_STORAGE is defined, in archetype tables. Both
+ * may relocate components when the storage changes : use a ComponentHandle
+ * to keep a reference across such changes.
+ *
+ * e.g. template <> struct ComponentTraits<Velocity> : ArchetypeStorage {};
+ */
+template <typename T>
+struct ComponentTraits
+    : std::conditional_t<std::is_polymorphic<T>::value ||
+                             !std::is_move_constructible<T>::value ||
+                             !std::is_move_assignable<T>::value,
+                         StableStorage, DefaultStorage> {};
 
 class IComponentArray {
    public:
     virtual ~IComponentArray() = default;
     virtual void entityDestroyed(EntityID) = 0;
+
+    // room for count components without reallocating
+    virtual void reserve(std::size_t count) = 0;
+
+    virtual std::size_t size() const = 0;
 };
 
 template <typename T>
 class ComponentArray : public IComponentArray {
     const std::string name = typeid(T).name();
 
+    static constexpr bool stable = ComponentTraits<T>::stable;
+
+    // packed components are stored by value,
+    // stable ones are owned through a pointer into the pool of T
+    using Slot =
+        std::conditional_t<stable, std::unique_ptr<T, PoolDeleter<T>>, T>;
+
    public:
     ComponentArray() = default;
 
-    ~ComponentArray() {
-        for (auto& component : _componentArray) {
-            delete component;
-            component = nullptr;
-        }
-    }
-
-    void insertData(EntityID entity, T* component) {
-        if (_entity_index.find(entity) != _entity_index.end()) {
+    // construct component in place
+    template <typename... TArgs>
+    T& emplaceData(EntityID entity, TArgs&&... args) {
+        if (auto component = getData(entity); component) {
             Logger::warn()
                 << name
                 << ": Component added to the same entity more than once!";
             Logger::endline();
 
-            return;
+            return *component;
         }
 
-        _entity_index[entity] = _size;
-        _index_entity[_size] = entity;
-        _componentArray[_size] = component;
+        if constexpr (stable)
+            _componentArray.emplace_back(
+                Pool<T>::create(std::forward<TArgs>(args)...));
+        else
+            _componentArray.emplace_back(std::forward<TArgs>(args)...);
 
-        ++_size;
+        return _at(_entities.insert(entity));
+    }
+
+    // take ownership of a heap allocated component
+    void insertData(EntityID entity, T* component) {
+        if constexpr (stable) {
+            if (_entities.contains(entity)) {
+                Logger::warn()
+                    << name
+                    << ": Component added to the same entity more than once!";
+                Logger::endline();
+
+                delete component;
+                return;
+            }
+
+            _componentArray.emplace_back(component, PoolDeleter<T>{false});
+            _entities.insert(entity);
+        } else {
+            emplaceData(entity, std::move(*component));
+            delete component;
+        }
     }
 
     void removeData(EntityID entity) {
-        if (_entity_index.find(entity) == _entity_index.end()) {
+        auto index = _entities.erase(entity);
+        if (index == SparseSet::npos) {
             Logger::warn() << name << ": Removing non-existent Component!";
             Logger::endline();
 
             return;
         }
 
-        size_t entityIndex = _entity_index[entity];
-        size_t lastIndex = _size - 1;
+        // keep buffer packed the same way the sparse set did
+        if (index != _componentArray.size() - 1)
+            _componentArray[index] = std::move(_componentArray.back());
+        _componentArray.pop_back();
+    }
 
-        delete _componentArray[entityIndex];
-        _componentArray[entityIndex] = _componentArray[lastIndex];
-        _componentArray[lastIndex] = nullptr;
+    T* getData(EntityID entity) {
+        auto index = _entities.find(entity);
+        if (index == SparseSet::npos) return nullptr;
+        return &_at(index);
+    }
 
-        EntityID lastEntity = _index_entity[lastIndex];
-        _entity_index[lastEntity] = entityIndex;
-        _index_entity[entityIndex] = lastEntity;
+    void entityDestroyed(EntityID entity) {
+        if (_entities.contains(entity)) removeData(entity);
+    }
 
-        _entity_index.erase(entity);
-        _index_entity.erase(entityIndex);
+    bool contains(EntityID entity) const { return _entities.contains(entity); }
 
-        --_size;
+    void reserve(std::size_t count) override {
+        _componentArray.reserve(count);
+        _entities.reserve(count);
     }
 
-    T* getData(EntityID entity) {
-        if (_entity_index.find(entity) != _entity_index.end())
-            return _componentArray[_entity_index[entity]];
-        return nullptr;
+    // number of components stored
+    size_t size() const override { return _entities.size(); }
+
+    // owners of the components, in storage order
+    const std::vector<EntityID>& entities() const {
+        return _entities.entities();
     }
 
-    void entityDestroyed(EntityID entity) {
-        if (_entity_index.find(entity) != _entity_index.end())
-            removeData(entity);
+    // owner of the i-th component
+    EntityID entityAt(size_t i) const { return _entities[i]; }
+
+    // i-th component, in storage order
+    T& componentAt(size_t i) { return _at(i); }
+
+    // apply process on each component, in storage order
+    template <typename F>
+    void each(F process) {
+        for (size_t i = 0; i < _componentArray.size(); ++i)
+            process(_entities[i], _at(i));
     }
 
    private:
-    size_t _size = 0;
-    std::array<T*, MAX_ENTITIES> _componentArray;
-    std::unordered_map<EntityID, size_t> _entity_index;
-    std::unordered_map<size_t, EntityID> _index_entity;
-};
\ No newline at end of file
+    T& _at(size_t i) {
+        if constexpr (stable)
+            return *_componentArray[i];
+        else
+            return _componentArray[i];
+    }
+
+    std::vector<Slot> _componentArray;
+    SparseSet _entities;
+};
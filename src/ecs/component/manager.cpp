@@ -1,7 +1,13 @@
 #include "manager.h"
 
+#include <algorithm>
+
+#include "../query/query.h"
+
 ComponentManager* ComponentManager::instance = nullptr;
 
+std::atomic<ComponentTypeID> ComponentManager::_nextComponentTypeID(0);
+
 ComponentManager& ComponentManager::Get()
 {
 	if (!instance)
@@ -9,8 +15,72 @@ ComponentManager& ComponentManager::Get()
 	return *instance;
 }
 
-void ComponentManager::entityDestroyed(EntityID e)
+void ComponentManager::entityDestroyed(EntityID e, const Signature& signature)
+{
+	auto count = std::min(_componentArrays.size(), signature.size());
+	for (std::size_t id = 0; id < count; ++id)
+		if (signature[id] && _componentArrays[id])
+			_componentArrays[id]->entityDestroyed(e);
+
+	_archetypes.entityDestroyed(e);
+
+	for (auto query : _queries)
+		query->_entityDestroyed(e);
+}
+
+void ComponentManager::signatureChanged(Entity& entity, ComponentTypeID type)
+{
+	if (type < _componentQueries.size())
+		for (auto query : _componentQueries[type])
+			query->_signatureChanged(entity);
+
+	for (auto query : _anyComponentQueries)
+		query->_signatureChanged(entity);
+}
+
+void ComponentManager::registerQuery(Query* query)
+{
+	_queries.push_back(query);
+
+	auto components = query->_components();
+	if (components.none()) {
+		_anyComponentQueries.push_back(query);
+		return;
+	}
+
+	for (std::size_t type = 0; type < components.size(); ++type)
+		if (components[type]) {
+			if (type >= _componentQueries.size())
+				_componentQueries.resize(type + 1);
+			_componentQueries[type].push_back(query);
+		}
+}
+
+void ComponentManager::_unindexQuery(Query* query)
+{
+	auto erase = [query](std::vector<Query*>& queries) {
+		queries.erase(std::remove(queries.begin(), queries.end(), query), queries.end());
+	};
+
+	auto components = query->_components();
+	for (std::size_t type = 0; type < _componentQueries.size(); ++type)
+		if (components[type]) erase(_componentQueries[type]);
+	erase(_anyComponentQueries);
+}
+
+void ComponentManager::groupDestroyed(const Group* group)
+{
+	auto it = std::remove_if(_queries.begin(), _queries.end(), [&](Query* query) {
+		if (query->_scope != group) return false;
+		_unindexQuery(query);
+		query->_orphan();
+		return true;
+	});
+	_queries.erase(it, _queries.end());
+}
+
+void ComponentManager::unregisterQuery(Query* query)
 {
-	for (auto& [_, array] : _componentArrays)
-		array->entityDestroyed(e);
+	_unindexQuery(query);
+	_queries.erase(std::remove(_queries.begin(), _queries.end(), query), _queries.end());
 }
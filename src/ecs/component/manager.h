@@ -6,84 +6,382 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <iostream>
-#include <unordered_map>
 #include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include "array.h"
+#include "../archetype/archetype.h"
 #include "../defs.h"
+#include "../../job/job.h"
 
 class Entity;
+class Query;
+class Group;
 
 class ComponentManager
 {
+public:
+
+    /**
+     * Apply process(EntityID, Ts&...) on every entity holding all of Ts.
+     * Archetype stored components are walked chunk by chunk, otherwise the
+     * smallest array among Ts drives the iteration.
+     * Don't attach/distach any of Ts while iterating.
+     */
+    template<typename... Ts, typename F>
+    static void each(F&& process)
+    { Get()._each<Ts...>(process); }
+
+    /**
+     * Same as each but split in cache sized ranges processed by the job
+     * system workers, return once every entity has been processed.
+     * process is called concurrently : it must only touch the components
+     * it receives. No component may be attached or distached meanwhile.
+     */
+    template<typename... Ts, typename F>
+    static void parallel_each(F&& process)
+    { Get()._parallelEach<Ts...>(process); }
+
+    // ID given to T on first use, shared by every manager instance
+    template<typename T>
+    static ComponentTypeID getComponentTypeID()
+    {
+        static const ComponentTypeID id = _nextComponentTypeID++;
+        assert(id < MAX_COMPONENTS && "Too many component types");
+        return id;
+    }
+
 private:
 
     static ComponentManager& Get();
     
     template<typename T>
-    ComponentTypeID getComponentTypeID()
+    void addComponent(EntityID e, T* component)
     {
-        const char* typeName = typeid(T).name();
-
-        if(_componentTypeID.find(typeName) == _componentTypeID.end())
-            registerComponent<T>();
-
-        return _componentTypeID[typeName];
+        if constexpr (ComponentTraits<T>::archetype) {
+            addComponent<T>(e, std::move(*component));
+            delete component;
+        } else
+            getComponentArray<T>()->insertData(e, component);
     }
 
-    template<typename T>
-    void addComponent(EntityID e, T* component)
+    // construct component directly into its storage
+    template<typename T, typename... TArgs>
+    T& addComponent(EntityID e, TArgs&&... args)
     {
-        getComponentArray<T>()->insertData(e, component);
+        if constexpr (ComponentTraits<T>::archetype) {
+            auto type = getComponentTypeID<T>();
+            if (auto component = _archetypes.get<T>(e, type); component) {
+                Logger::warn()
+                    << typeid(T).name()
+                    << ": Component added to the same entity more than once!";
+                Logger::endline();
+
+                return *component;
+            }
+            return _archetypes.emplace<T>(e, type, std::forward<TArgs>(args)...);
+        } else
+            return getComponentArray<T>()->emplaceData(e, std::forward<TArgs>(args)...);
     }
 
     template<typename T>
     void removeComponent(EntityID e)
     {
-        getComponentArray<T>()->removeData(e);
+        if constexpr (ComponentTraits<T>::archetype)
+            _archetypes.remove(e, getComponentTypeID<T>());
+        else
+            getComponentArray<T>()->removeData(e);
     }
 
+    // lookups never create storage, they may run on worker threads
     template<typename T>
     T* getComponent(EntityID e)
-    { return getComponentArray<T>()->getData(e); }
+    {
+        if constexpr (ComponentTraits<T>::archetype)
+            return _archetypes.get<T>(e, getComponentTypeID<T>());
+        else {
+            auto array = _find<T>();
+            return array ? array->getData(e) : nullptr;
+        }
+    }
+
+    // remove entity from arrays of the components it holds
+    void entityDestroyed(EntityID, const Signature&);
+
+    // keep queries mentioning this component in sync with the entity signature
+    void signatureChanged(Entity&, ComponentTypeID);
 
-    void entityDestroyed(EntityID);
+    void registerQuery(Query*);
+    void unregisterQuery(Query*);
+
+    // orphan queries scoped to a group being destroyed
+    void groupDestroyed(const Group*);
 
     template<typename T>
     void registerComponent()
     {
-        const char* typeName = typeid(T).name();
+        auto id = getComponentTypeID<T>();
 
-		if (_componentTypeID.find(typeName) != std::end(_componentTypeID))
-			return;
+        if (id >= _componentArrays.size())
+            _componentArrays.resize(id + 1);
 
-        _componentTypeID.insert({typeName, _nextComponentTypeID});
-        _componentArrays.insert({typeName, std::make_shared<ComponentArray<T>>()});
+        if (!_componentArrays[id])
+            _componentArrays[id] = std::make_unique<ComponentArray<T>>();
+    }
 
-        ++_nextComponentTypeID;
+    // create storage of T ahead of use
+    template<typename T>
+    void prepare()
+    {
+        if constexpr (ComponentTraits<T>::archetype)
+            _archetypes.registerType<T>(getComponentTypeID<T>());
+        else
+            registerComponent<T>();
     }
 
+    // room for additional components of T, archetype tables grow by chunks
     template<typename T>
-    std::shared_ptr<ComponentArray<T>> getComponentArray()
+    void reserve(std::size_t additional)
     {
-        const char* typeName = typeid(T).name();
+        if constexpr (ComponentTraits<T>::archetype)
+            prepare<T>();
+        else {
+            auto array = getComponentArray<T>();
+            array->reserve(array->size() + additional);
+        }
+    }
 
-        if (_componentTypeID.find(typeName) == std::end(_componentTypeID))
+    template<typename T>
+    ComponentArray<T>* getComponentArray()
+    {
+        auto id = getComponentTypeID<T>();
+
+        if (id >= _componentArrays.size() || !_componentArrays[id])
             registerComponent<T>();
 
-        return std::static_pointer_cast<ComponentArray<T>>(_componentArrays[typeName]);
+        return static_cast<ComponentArray<T>*>(_componentArrays[id].get());
+    }
+
+    // array of T if it was registered
+    template<typename T>
+    ComponentArray<T>* _find()
+    {
+        auto id = getComponentTypeID<T>();
+        if (id >= _componentArrays.size()) return nullptr;
+        return static_cast<ComponentArray<T>*>(_componentArrays[id].get());
+    }
+
+    // array of T, null for archetype stored components
+    template<typename T>
+    ComponentArray<T>* _array()
+    {
+        if constexpr (ComponentTraits<T>::archetype)
+            return nullptr;
+        else
+            return getComponentArray<T>();
+    }
+
+    // component of the entity, from a chunk column or from its array
+    template<typename T>
+    static T* _fetch(std::byte* column, std::size_t row, ComponentArray<T>* array, EntityID e)
+    {
+        if constexpr (ComponentTraits<T>::archetype)
+            return reinterpret_cast<T*>(column) + row;
+        else
+            return array->getData(e);
+    }
+
+    // start of the column of T in the chunk, null for other storages
+    template<typename T>
+    std::byte* _column(Archetype& archetype, Archetype::Chunk& chunk)
+    {
+        if constexpr (ComponentTraits<T>::archetype)
+            return archetype.column(chunk, getComponentTypeID<T>());
+        else
+            return nullptr;
+    }
+
+    template<typename... Ts, typename F>
+    void _each(F& process)
+    { _eachImpl<Ts...>(process, std::index_sequence_for<Ts...>()); }
+
+    template<typename... Ts, typename F, std::size_t... Is>
+    void _eachImpl(F& process, std::index_sequence<Is...> seq)
+    {
+        std::tuple<ComponentArray<Ts>*...> arrays(_array<Ts>()...);
+
+        auto tables = _tables<Ts...>();
+        if (tables.any()) {
+            _archetypes.eachChunk(tables, [&](Archetype& archetype, Archetype::Chunk& chunk) {
+                _eachRow<Ts...>(process, archetype, chunk, arrays, seq);
+            });
+            return;
+        }
+
+        if (auto entities = _smallest(arrays, seq))
+            _eachEntity<Ts...>(process, *entities, 0, entities->size(), arrays, seq);
+    }
+
+    template<typename... Ts, typename F>
+    void _parallelEach(F& process)
+    { _parallelEachImpl<Ts...>(process, std::index_sequence_for<Ts...>()); }
+
+    template<typename... Ts, typename F, std::size_t... Is>
+    void _parallelEachImpl(F& process, std::index_sequence<Is...> seq)
+    {
+        // arrays are registered here, before workers look them up
+        std::tuple<ComponentArray<Ts>*...> arrays(_array<Ts>()...);
+        auto jobs = JobSystem::Get();
+
+        auto tables = _tables<Ts...>();
+        if (tables.any()) {
+            // chunks are already cache sized, one job each
+            std::vector<std::pair<Archetype*, Archetype::Chunk*>> chunks;
+            _archetypes.eachChunk(tables, [&](Archetype& archetype, Archetype::Chunk& chunk) {
+                chunks.emplace_back(&archetype, &chunk);
+            });
+
+            jobs->parallel_for(0, chunks.size(), 1, [&](std::size_t first, std::size_t last) {
+                for (auto i = first; i < last; ++i)
+                    _eachRow<Ts...>(process, *chunks[i].first, *chunks[i].second, arrays, seq);
+            });
+            return;
+        }
+
+        auto entities = _smallest(arrays, seq);
+        if (!entities) return;
+
+        // as many entities as components of an archetype chunk
+        std::size_t grain = std::max<std::size_t>(1, Archetype::CHUNK_BYTES / (sizeof(Ts) + ...));
+
+        jobs->parallel_for(0, entities->size(), grain, [&](std::size_t first, std::size_t last) {
+            _eachEntity<Ts...>(process, *entities, first, last, arrays, seq);
+        });
+    }
+
+    // archetype stored components among Ts
+    template<typename... Ts>
+    static Signature _tables()
+    {
+        Signature tables;
+        ((ComponentTraits<Ts>::archetype ? (void)tables.set(getComponentTypeID<Ts>()) : (void)0), ...);
+        return tables;
+    }
+
+    // entities of the smallest array, null if there is none
+    template<typename... Ts, std::size_t... Is>
+    static const std::vector<EntityID>* _smallest(std::tuple<ComponentArray<Ts>*...>& arrays, std::index_sequence<Is...>)
+    {
+        const std::vector<EntityID>* entities = nullptr;
+        ((entities = (!entities || std::get<Is>(arrays)->size() < entities->size())
+                         ? &std::get<Is>(arrays)->entities()
+                         : entities), ...);
+        return entities;
+    }
+
+    template<typename... Ts, typename F, std::size_t... Is>
+    void _eachRow(F& process, Archetype& archetype, Archetype::Chunk& chunk,
+                  std::tuple<ComponentArray<Ts>*...>& arrays, std::index_sequence<Is...>)
+    {
+        std::byte* columns[] = { _column<Ts>(archetype, chunk)... };
+
+        for (std::size_t row = 0; row < chunk.count; ++row) {
+            auto e = chunk.entities[row];
+            std::tuple<Ts*...> components(
+                _fetch<Ts>(columns[Is], row, std::get<Is>(arrays), e)...);
+
+            if ((std::get<Is>(components) && ...))
+                process(e, *std::get<Is>(components)...);
+        }
+    }
+
+    template<typename... Ts, typename F, std::size_t... Is>
+    static void _eachEntity(F& process, const std::vector<EntityID>& entities,
+                            std::size_t first, std::size_t last,
+                            std::tuple<ComponentArray<Ts>*...>& arrays, std::index_sequence<Is...>)
+    {
+        for (auto i = first; i < last; ++i) {
+            auto e = entities[i];
+            std::tuple<Ts*...> components(std::get<Is>(arrays)->getData(e)...);
+
+            if ((std::get<Is>(components) && ...))
+                process(e, *std::get<Is>(components)...);
+        }
     }
 
 private:
 
-	ComponentManager() : _nextComponentTypeID(0)
+	ComponentManager()
 	{ instance = this; }
     
 	static ComponentManager* instance;
 
-    std::unordered_map<const char*, ComponentTypeID> _componentTypeID;
-    std::unordered_map<const char*, std::shared_ptr<IComponentArray>> _componentArrays;
-    ComponentTypeID _nextComponentTypeID;
+    static std::atomic<ComponentTypeID> _nextComponentTypeID;
+
+    // indexed by component type ID
+    std::vector<std::unique_ptr<IComponentArray>> _componentArrays;
+
+    // tables of archetype stored components
+    ArchetypeRegistry _archetypes;
+
+    std::vector<Query*> _queries;
+
+    // queries to update when a component is attached or distached,
+    // indexed by component type ID
+    std::vector<std::vector<Query*>> _componentQueries;
+
+    // queries mentioning no component, updated on every change
+    std::vector<Query*> _anyComponentQueries;
+
+    // remove the query from the lists above
+    void _unindexQuery(Query*);
 
 friend class Entity;
+friend class Group;
+friend class Query;
+friend class ISystem;
+friend class CommandBuffer;
+template<typename> friend class ComponentHandle;
+};
+
+/**
+ * Reference to a component that stays valid when its array relocates
+ * components, resolved by entity on each access.
+ */
+template<typename T>
+class ComponentHandle
+{
+public:
+    ComponentHandle() = default;
+
+    explicit ComponentHandle(EntityID e) : _entity(e)
+    {}
+
+    // null if the entity doesn't hold the component anymore
+    T* get() const
+    {
+        if (_entity == NULL_ENTITY)
+            return nullptr;
+        return ComponentManager::Get().getComponent<T>(_entity);
+    }
+
+    T* operator->() const
+    { return get(); }
+
+    T& operator*() const
+    { return *get(); }
+
+    operator bool() const
+    { return get() != nullptr; }
+
+    EntityID entity() const
+    { return _entity; }
+
+private:
+    EntityID _entity = NULL_ENTITY;
 };
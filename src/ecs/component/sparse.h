@@ -0,0 +1,121 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Paged sparse set mapping entities to packed indexes
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../defs.h"
+
+/**
+ * Sparse set of entities
+ *
+ * The sparse part is a table of fixed size pages, allocated on demand and
+ * indexed by entity slot, holding the position of the entity in the dense
+ * part. Stale IDs are rejected by comparing with the stored entity.
+ * The dense part packs entities in insertion order (until a removal swaps
+ * the last entity in) and is meant to be walked for iteration.
+ */
+class SparseSet {
+   public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    // return position of the entity in the dense array, npos if absent
+    std::size_t find(EntityID entity) const {
+        auto key = _key(entity);
+        auto page = key / PAGE_SIZE;
+
+        if (page >= _pages.size() || !_pages[page]) return npos;
+
+        auto index = (*_pages[page])[key % PAGE_SIZE];
+        if (index == TOMBSTONE) return npos;
+
+        // slot reused by a newer generation of the entity
+        if (_dense[index] != entity) return npos;
+
+        return index;
+    }
+
+    bool contains(EntityID entity) const { return find(entity) != npos; }
+
+    // append the entity and return its position in the dense array
+    // entity must not be in the set already
+    std::size_t insert(EntityID entity) {
+        auto position = _dense.size();
+        _slot(entity) = std::uint32_t(position);
+        _dense.push_back(entity);
+        return position;
+    }
+
+    /**
+     * Remove the entity by moving the last one into its place.
+     * Data held in parallel of the dense array must apply the same swap.
+     *
+     * @return former position of the removed entity, npos if absent
+     */
+    std::size_t erase(EntityID entity) {
+        auto position = find(entity);
+        if (position == npos) return npos;
+
+        auto last = _dense.back();
+        _dense[position] = last;
+        _slot(last) = std::uint32_t(position);
+
+        _slot(entity) = TOMBSTONE;
+        _dense.pop_back();
+
+        return position;
+    }
+
+    // room for count entities without reallocating the dense array
+    void reserve(std::size_t count) { _dense.reserve(count); }
+
+    void clear() {
+        _pages.clear();
+        _dense.clear();
+    }
+
+    std::size_t size() const { return _dense.size(); }
+
+    bool empty() const { return _dense.empty(); }
+
+    // entities in iteration order
+    const std::vector<EntityID>& entities() const { return _dense; }
+
+    EntityID operator[](std::size_t position) const {
+        return _dense[position];
+    }
+
+   private:
+    static constexpr std::size_t PAGE_SIZE = 4096;
+    static constexpr std::uint32_t TOMBSTONE =
+        std::numeric_limits<std::uint32_t>::max();
+
+    using Page = std::array<std::uint32_t, PAGE_SIZE>;
+
+    static std::size_t _key(EntityID entity) { return entityIndex(entity); }
+
+    // sparse slot of the entity, allocating its page if needed
+    std::uint32_t& _slot(EntityID entity) {
+        auto key = _key(entity);
+        auto page = key / PAGE_SIZE;
+
+        if (page >= _pages.size()) _pages.resize(page + 1);
+        if (!_pages[page]) {
+            _pages[page] = std::make_unique<Page>();
+            _pages[page]->fill(TOMBSTONE);
+        }
+
+        return (*_pages[page])[key % PAGE_SIZE];
+    }
+
+    std::vector<std::unique_ptr<Page>> _pages;
+    std::vector<EntityID> _dense;
+};
@@ -13,65 +13,76 @@ void spriteRenderer::Render() {
         return;
     }
 
+    if (!get<sprite>().texture) return;  // no texture to draw
+
+    if (!has<transform>())
+        attach<transform>();  // default position, rotation and scale factor
     auto& spriteComponent = get<sprite>();
-    if (!spriteComponent.texture) return;  // no texture to draw
+    auto& t = get<transform>();
+    auto& texture = spriteComponent.texture;
+    auto pos = t.position;
+    auto scale = t.scale;
+    auto tSize = texture.getSize();
+    SDL_Rect src;
+    VectorI frameSize;
+    int w, h;
 
-    RenderManager::Get()->submit([&](SDL_Renderer* renderer) {
-        if (!has<transform>())
-            attach<transform>();  // default position, rotation and scale factor
-        auto& t = get<transform>();
-        auto& texture = spriteComponent.texture;
-        auto pos = t.position;
-        auto scale = t.scale;
-        auto rotation = t.rotation;
-        auto tSize = texture.getSize();
-        SDL_Rect src;
-        VectorI frameSize;
-        int w, h;
+    // check bounds
+    if (spriteComponent.framesNumber.x <= 0 or
+        spriteComponent.framesNumber.y <= 0 or
+        spriteComponent.frame >=
+            spriteComponent.framesNumber.x * spriteComponent.framesNumber.y)
+        return;
 
-        // check bounds
-        if (spriteComponent.framesNumber.x <= 0 or
-            spriteComponent.framesNumber.y <= 0 or
-            spriteComponent.frame >=
-                spriteComponent.framesNumber.x * spriteComponent.framesNumber.y)
-            return;
+    // select area
+    if (spriteComponent.regionEnabled) {
+        src.x = spriteComponent.region.x;
+        src.y = spriteComponent.region.y;
+        w = spriteComponent.region.w;
+        h = spriteComponent.region.h;
+    }
+    // use whole texture
+    else {
+        src.x = src.y = 0;
+        w = tSize.x;
+        h = tSize.y;
+    }
 
-        // select area
-        if (spriteComponent.regionEnabled) {
-            src.x = spriteComponent.region.x;
-            src.y = spriteComponent.region.y;
-            w = spriteComponent.region.w;
-            h = spriteComponent.region.h;
-        }
-        // use whole texture
-        else {
-            src.x = src.y = 0;
-            w = tSize.x;
-            h = tSize.y;
-        }
+    // compute frame size
+    frameSize.x = w / spriteComponent.framesNumber.x;
+    frameSize.y = h / spriteComponent.framesNumber.y;
 
-        // compute frame size
-        frameSize.x = w / spriteComponent.framesNumber.x;
-        frameSize.y = h / spriteComponent.framesNumber.y;
+    // compute source rect
+    src.x +=
+        (spriteComponent.frame % spriteComponent.framesNumber.x) * frameSize.x;
+    src.y +=
+        (spriteComponent.frame / spriteComponent.framesNumber.x) * frameSize.y;
+    src.w = frameSize.x;
+    src.h = frameSize.y;
 
-        // compute source rect
-        src.x += (spriteComponent.frame % spriteComponent.framesNumber.x) *
-                 frameSize.x;
-        src.y += (spriteComponent.frame / spriteComponent.framesNumber.x) *
-                 frameSize.y;
-        src.w = frameSize.x;
-        src.h = frameSize.y;
+    // destination
+    pos += spriteComponent.offset;
 
-        // destination
-        pos += spriteComponent.offset;
+    // center destination
+    if (spriteComponent.centered) pos -= {src.w * 0.5, src.h * 0.5};
 
-        // center destination
-        if (spriteComponent.centered) pos -= {src.w * 0.5, src.h * 0.5};
+    // quads are copied, no reference to the sprite is kept until drawing
+    Quad quad;
+    quad.texture = texture.get();
+    quad.source = src;
+    // texture may be a region of an atlas page
+    auto region = texture.getRegion();
+    quad.source.x += region.x;
+    quad.source.y += region.y;
+    quad.destination = {int(pos.x), int(pos.y), int(src.w * scale.x),
+                        int(src.h * scale.y)};
+    quad.center = {src.w / 2, src.h / 2};  // rotate around center for now
+    quad.angle = t.rotation;
+    quad.flip = SDL_RendererFlip((spriteComponent.flip.y << 1) |
+                                 spriteComponent.flip.x);
 
-        // rotate around center for now
-        texture.draw(src, {int(pos.x), int(pos.y)}, {src.w / 2, src.h / 2},
-                     rotation, spriteComponent.flip, scale);
-    });
+    // submission follows group order, depth only applies to sorted layers
+    RenderManager::Get()->submit(quad, 0, spriteComponent.depth);
 }
 
 void sprite::setTexture(const std::string& fileName) { texture.load(fileName); }
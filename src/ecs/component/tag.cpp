@@ -0,0 +1,31 @@
+#include "../components.h"
+
+namespace Component {
+
+void tag::set(const std::string &str) {
+    auto previous = _content;
+    _content = str;
+    if (entity) entity->_tagRenamed(previous, *this);
+}
+
+tag &tag::operator=(const tag &other) {
+    if (this != &other) set(other._content);
+    return *this;
+}
+
+tag &tag::operator=(tag &&other) noexcept {
+    if (this == &other) return *this;
+
+    if (!other.entity) {
+        set(other._content);
+        return *this;
+    }
+
+    // storage compaction : the previous owner was already unindexed
+    _content = std::move(other._content);
+    entity = other.entity;
+    other.entity = nullptr;
+    return *this;
+}
+
+}  // namespace Component
@@ -1,6 +1,7 @@
 #include <algorithm>
 
 #include "../../../logger/logger.h"
+#include "../../../pack/assets.h"
 #include "../../../renderer/renderer.h"
 #include "../../components.h"
 
@@ -9,7 +10,11 @@ namespace Component {
 tson::Tileson Tilemap::tileson;
 
 Tilemap::Tilemap(const std::string &rsc) : file(rsc) {
-    _map = tileson.parse(fs::path(rsc));
+    // cooked maps are parsed from the pack memory
+    if (PackReader::Blob blob; AssetPack::Get()->tilemap(rsc, blob))
+        _map = tileson.parse(blob.data, blob.size);
+    else
+        _map = tileson.parse(fs::path(rsc));
     if (_map->getStatus() == tson::ParseStatus::OK)
         Logger::info("Component", "Tilemap") << rsc << " loaded";
     else
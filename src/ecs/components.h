@@ -27,12 +27,39 @@ namespace Component {
 
 // Identify entities with tag and IDs
 struct tag {
-    std::string content = "";
-    bool operator==(const std::string &str) const { return content == str; }
-
-    tag(const std::string &str) : content(str) {}
+    tag(const std::string &str) : _content(str) {}
 
     tag() {}
+
+    // a copy isn't attached to the entity of the original
+    tag(const tag &other) : _content(other._content) {}
+
+    // storages relocate components by moving, the entity follows
+    tag(tag &&other) noexcept
+        : _content(std::move(other._content)), entity(other.entity) {
+        other.entity = nullptr;
+    }
+
+    // rename this tag, the entity of other is never taken
+    tag &operator=(const tag &other);
+
+    // relocation when other is attached, rename otherwise
+    tag &operator=(tag &&other) noexcept;
+
+    const std::string &str() const { return _content; }
+
+    bool operator==(const std::string &str) const { return _content == str; }
+
+    // rename and keep the group tag index up to date
+    void set(const std::string &str);
+
+   private:
+    std::string _content;
+
+    // set when attached
+    Entity *entity = nullptr;
+
+    friend class ::Entity;
 };
 
 // Space specs
@@ -88,6 +115,11 @@ struct sprite {
     // default : 0, i.e first frame
     int frame = 0;
 
+    // drawing order in sorted layers, lower first, within [-32768, 32767]
+    // sprites sharing a depth keep submission order
+    // default : 0
+    int depth = 0;
+
     // use x-th in row and y-th in column frame
     // matrix coordinates system
     void setFrame(int, int);
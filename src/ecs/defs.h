@@ -7,11 +7,32 @@
 #pragma once
 
 #include <bitset>
+#include <cstdint>
 
 using EntityID = std::uint32_t;
 using ComponentTypeID = std::uint32_t;
 
-const EntityID MAX_ENTITIES  = 0x100;
+// EntityID layout : low bits are the index of the entity slot,
+// high bits count how many times that slot has been reused
+const std::uint8_t ENTITY_INDEX_BITS = 20;
+const EntityID ENTITY_INDEX_MASK = (EntityID(1) << ENTITY_INDEX_BITS) - 1;
+const EntityID ENTITY_GENERATION_MASK = ~EntityID(0) >> ENTITY_INDEX_BITS;
+
+// ID never given to an entity, last slot index is kept for it
+const EntityID NULL_ENTITY = ~EntityID(0);
+
+const EntityID MAX_ENTITIES  = ENTITY_INDEX_MASK;
 const std::uint8_t MAX_COMPONENTS = 0xff;
 
 using Signature = std::bitset<MAX_COMPONENTS>;
+
+// slot index of the entity, usable to index arrays
+inline EntityID entityIndex(EntityID id) { return id & ENTITY_INDEX_MASK; }
+
+// how many times the entity slot has been recycled
+inline EntityID entityGeneration(EntityID id) { return id >> ENTITY_INDEX_BITS; }
+
+inline EntityID makeEntityID(EntityID index, EntityID generation) {
+    return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) |
+           (index & ENTITY_INDEX_MASK);
+}
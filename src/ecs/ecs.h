@@ -7,11 +7,14 @@
 #ifndef ECS_H
 #define ECS_H
 
+#include "command/command.h"
 #include "component/array.h"
 #include "component/manager.h"
 #include "components.h"
 #include "entity/entity.h"
 #include "group/group.h"
+#include "query/query.h"
+#include "view/view.h"
 #include "system/system.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "allocator.h"
+
+#include <algorithm>
+
+EntityID EntityAllocator::create() {
+    if (!_free.empty()) {
+        auto index = _free.back();
+        _free.pop_back();
+        _freePosition[index] = NPOS;
+
+        _alive[index] = true;
+        ++_size;
+        return _slots[index];
+    }
+
+    if (_slots.size() >= MAX_ENTITIES) return NULL_ENTITY;
+
+    auto id = makeEntityID(EntityID(_slots.size()), 0);
+    _slots.push_back(id);
+    _alive.push_back(true);
+    _freePosition.push_back(NPOS);
+    ++_size;
+
+    return id;
+}
+
+EntityID EntityAllocator::create(EntityID id) {
+    auto index = entityIndex(id);
+    if (index >= MAX_ENTITIES) return create();
+
+    if (index >= _slots.size()) {
+        // slots skipped over become available
+        for (auto i = EntityID(_slots.size()); i < index; ++i) {
+            _slots.push_back(makeEntityID(i, 0));
+            _alive.push_back(false);
+            _freePosition.push_back(std::uint32_t(_free.size()));
+            _free.push_back(i);
+        }
+        _slots.push_back(makeEntityID(index, 0));
+        _alive.push_back(false);
+        _freePosition.push_back(NPOS);
+    }
+
+    if (_alive[index]) return create();
+
+    _unfree(index);
+
+    // never go back to an older generation, handles from a previous
+    // lifetime of the slot would match again
+    auto generation =
+        std::max(entityGeneration(_slots[index]), entityGeneration(id));
+    _slots[index] = makeEntityID(index, generation);
+    _alive[index] = true;
+    ++_size;
+
+    return _slots[index];
+}
+
+void EntityAllocator::_unfree(EntityID index) {
+    auto position = _freePosition[index];
+    if (position == NPOS) return;
+
+    // swap with the last free index
+    auto last = _free.back();
+    _free[position] = last;
+    _freePosition[last] = position;
+    _free.pop_back();
+    _freePosition[index] = NPOS;
+}
+
+void EntityAllocator::destroy(EntityID id) {
+    if (!alive(id)) return;
+
+    auto index = entityIndex(id);
+    _slots[index] = makeEntityID(index, entityGeneration(id) + 1);
+    _alive[index] = false;
+    _freePosition[index] = std::uint32_t(_free.size());
+    _free.push_back(index);
+    --_size;
+}
+
+bool EntityAllocator::alive(EntityID id) const {
+    auto index = entityIndex(id);
+    return index < _slots.size() && _alive[index] && _slots[index] == id;
+}
+
+std::size_t EntityAllocator::size() const { return _size; }
+
+std::size_t EntityAllocator::capacity() const { return _slots.size(); }
+
+void EntityAllocator::clear() {
+    _slots.clear();
+    _alive.clear();
+    _free.clear();
+    _freePosition.clear();
+    _size = 0;
+}
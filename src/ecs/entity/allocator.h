@@ -0,0 +1,61 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Generational allocator for entity IDs
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../defs.h"
+
+/**
+ * Hands out entity IDs in O(1)
+ *
+ * Indexes of destroyed entities go to a free list and are reused first,
+ * keeping indexes dense. Each reuse bumps the slot generation so that IDs
+ * of destroyed entities never match a living one.
+ */
+class EntityAllocator {
+   public:
+    // return NULL_ENTITY if there is no slot left
+    EntityID create();
+
+    // claim the index of the given ID, a fresh ID is created if the slot
+    // is taken. The slot generation never decreases : the returned ID
+    // differs from the requested one when it is older than the slot
+    EntityID create(EntityID);
+
+    void destroy(EntityID);
+
+    // check if the ID refers to a living entity
+    bool alive(EntityID) const;
+
+    // number of living entities
+    std::size_t size() const;
+
+    // upper bound of living entity indexes
+    std::size_t capacity() const;
+
+    void clear();
+
+   private:
+    // current ID held by each slot
+    std::vector<EntityID> _slots;
+    std::vector<bool> _alive;
+
+    std::vector<EntityID> _free;
+
+    // position of each slot in _free, NPOS when not free
+    std::vector<std::uint32_t> _freePosition;
+
+    std::size_t _size = 0;
+
+    static constexpr std::uint32_t NPOS = ~std::uint32_t(0);
+
+    // remove a slot from the free list
+    void _unfree(EntityID index);
+};
@@ -6,64 +6,78 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <set>
 #include <sstream>
 
 #include "../../application/application.h"
 #include "../../logger/logger.h"
+#include "../../pack/assets.h"
+#include "../../util/memory/pool.h"
 #include "../components.h"
 
-std::set<EntityID> Entity::takenID;
-std::unordered_map<EntityID, Entity*> Entity::instances;
+EntityAllocator Entity::allocator;
+std::vector<Entity*> Entity::instances;
 bool Entity::_cleanFlag = false;
 
-Entity::Entity()
-    : _id(_generateID(0, true)), _manager(ComponentManager::Get()) {
+Entity::Entity() : _id(allocator.create()), _manager(ComponentManager::Get()) {
     _init();
 }
 
 Entity::Entity(EntityID id)
-    : _id(_generateID(id)), _manager(ComponentManager::Get()) {
+    : _id(allocator.create(id)), _manager(ComponentManager::Get()) {
     _init();
 }
 
+namespace {
+
+PoolAllocator& entityPool() {
+    static PoolAllocator instance("Entity", sizeof(Entity), alignof(Entity));
+    return instance;
+}
+
+}  // namespace
+
+void* Entity::operator new(std::size_t size) {
+    assert(size == sizeof(Entity));
+    return entityPool().allocate();
+}
+
+void Entity::operator delete(void* memory) { entityPool().deallocate(memory); }
+
 void Entity::_init() {
-    if ((EntityID)instances.size() >= MAX_ENTITIES) {
+    if (_id == NULL_ENTITY) {
         Logger::error("Entity") << "Maximum instance number reached!";
         Logger::endline();
 
         exit(1);
     }
-    instances[_id] = this;
-}
 
-EntityID Entity::_generateID(EntityID id, bool g) const {
-    if (takenID.empty()) srand(time(0));
-    while (takenID.find(id) != takenID.end() or g) {
-        g = false;
-        id = rand() % (1 << 31);
-    }
-    takenID.emplace(id);
-    return id;
+    auto index = entityIndex(_id);
+    if (index >= instances.size()) instances.resize(allocator.capacity());
+    instances[index] = this;
 }
 
 Entity::~Entity() {
     onDestroy();
 
-    _signature.reset();
-
     // remove from instances list
-    if (!_cleanFlag) instances.erase(_id);
+    if (!_cleanFlag) {
+        instances[entityIndex(_id)] = nullptr;
+        allocator.destroy(_id);
+    }
 
-    // signal all components that the entity has been destroyed
-    _manager.entityDestroyed(_id);
+    if (!_cleanFlag && has<Component::tag>()) _tagRemoved(get<Component::tag>());
+
+    // signal arrays of held components that the entity has been destroyed
+    _manager.entityDestroyed(_id, _signature);
+    _signature.reset();
 }
 
 // static
 void Entity::Clean() {
     _cleanFlag = true;
-    for (auto& [_, entity] : instances) delete entity;
+    for (auto entity : instances) delete entity;
     instances.clear();
+    allocator.clear();
 
     delete ComponentManager::instance;
     ComponentManager::instance = nullptr;
@@ -71,14 +85,38 @@ void Entity::Clean() {
 
 // static
 Entity* Entity::Get(EntityID id) {
-    auto ret = instances[id];
-    if (!ret) {
+    if (!allocator.alive(id)) {
         Logger::warn("Entity")
             << "There is no instance matching ID : " << idToString(id);
         Logger::endline();
+
+        return nullptr;
     }
 
-    return ret;
+    return instances[entityIndex(id)];
+}
+
+// static
+bool Entity::Alive(EntityID id) { return allocator.alive(id); }
+
+void Entity::_tagAttached(Component::tag& tag) {
+    tag.entity = this;
+    if (has<Component::group>())
+        get<Component::group>().content->_indexTag(_id, tag.str());
+}
+
+void Entity::_tagRemoved(const Component::tag& tag) {
+    if (has<Component::group>())
+        get<Component::group>().content->_unindexTag(_id, tag.str());
+}
+
+void Entity::_tagRenamed(const std::string& previous,
+                         const Component::tag& tag) {
+    if (has<Component::group>()) {
+        auto group = get<Component::group>().content;
+        group->_unindexTag(_id, previous);
+        group->_indexTag(_id, tag.str());
+    }
 }
 
 Entity::operator EntityID() const { return _id; }
@@ -92,6 +130,14 @@ std::string Entity::idToString(EntityID id) {
     return ss.str();
 }
 
+// static
+EntityID Entity::idFromString(const std::string& str) {
+    std::stringstream ss(str);
+    EntityID id = NULL_ENTITY;
+    ss >> std::hex >> id;
+    return id;
+}
+
 std::string Entity::idAsString() const { return idToString(_id); }
 
 bool Entity::operator==(const Entity& entity) const {
@@ -123,25 +169,32 @@ void Entity::onDestroy() {
 int Entity::getIndex() const { return index; }
 
 void Entity::setIndex(unsigned int i) {
+    if (index == i) return;
+
     index = i;
-    if (has<Component::group>()) get<Component::group>().content->reorder();
+    if (has<Component::group>())
+        get<Component::group>().content->invalidateOrder();
 }
 
 void Entity::useTemplate(const Path& path) {
     auto& serializer = Application::Get().getSerializer();
-    std::ifstream file(path);
+    YAML::Node n;
 
-    if (!file) {
-        Logger::error("Entity")
-            << "Failed to load template : '" << path << "' doesn't exist";
-        Logger::endline();
+    if (!AssetPack::Get()->document(path, n)) {
+        std::ifstream file(path);
 
-        return;
-    }
+        if (!file) {
+            Logger::error("Entity")
+                << "Failed to load template : '" << path << "' doesn't exist";
+            Logger::endline();
 
-    std::ostringstream ss;
-    ss << file.rdbuf();
-    auto n = YAML::Load(ss.str());
+            return;
+        }
+
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        n = YAML::Load(ss.str());
+    }
     serializer.deserializeEntity(n, *this);
 
     Logger::info("Entity") << path << " : Template loaded";
@@ -4,18 +4,21 @@
 #include <functional>
 #include <list>
 #include <memory>
-#include <set>
 #include <tuple>
-#include <unordered_map>
+#include <vector>
 
 #include "../../path/path.h"
 #include "../baseCamera.h"
 #include "../baseScript.h"
 #include "../component/manager.h"
 #include "../defs.h"
+#include "allocator.h"
 
 class Group;
-class EventManager;
+
+namespace Component {
+struct tag;
+}
 
 /**
  * Create an Entity using Group::create method
@@ -29,8 +32,12 @@ class Entity {
     static void Clean();
 
     // get entity with the given ID
+    // return null pointer if the entity has been destroyed
     static Entity* Get(EntityID);
 
+    // check if the ID refers to a living entity
+    static bool Alive(EntityID);
+
     /** construct entity using a template
      * @param fileName
      */
@@ -40,11 +47,12 @@ class Entity {
     int getIndex() const;
 
     // setter for index property
+    // the group is sorted again before its next iteration
     void setIndex(unsigned int);
 
     template <typename T>
     bool has() const {
-        return _signature[_manager.getComponentTypeID<T>()];
+        return _signature[ComponentManager::getComponentTypeID<T>()];
     }
 
     template <typename... T>
@@ -62,6 +70,9 @@ class Entity {
         return (!has<T>() && ...);
     }
 
+    // the reference is invalidated by the next attach or distach of T on
+    // any entity, of any component with archetype storage, unless T has a
+    // stable storage. Use handle() to keep it longer
     template <typename T>
     T& get() {
         auto component = _manager.getComponent<T>(_id);
@@ -82,12 +93,18 @@ class Entity {
         return std::tuple<T&...>(get<T>()...);
     }
 
+    // reference to the component that survives storage relocations
+    template <typename T>
+    ComponentHandle<T> handle() const {
+        return ComponentHandle<T>(_id);
+    }
+
+    // same lifetime as the reference returned by get()
     template <typename T, typename... TArgs>
     T& attach(TArgs&&... args) {
-        T* ret = new T(std::forward<TArgs>(args)...);
-
-        _manager.addComponent<T>(_id, ret);
-        _signature.set(_manager.getComponentTypeID<T>());
+        T* ret = &_manager.addComponent<T>(_id, std::forward<TArgs>(args)...);
+        _signature.set(ComponentManager::getComponentTypeID<T>());
+        _manager.signatureChanged(*this, ComponentManager::getComponentTypeID<T>());
 
         // Check if attaching script component
         if (std::is_base_of<Script, T>::value) {
@@ -105,6 +122,8 @@ class Entity {
             }
         }
 
+        if constexpr (std::is_same<T, Component::tag>::value) _tagAttached(*ret);
+
         return *ret;
     }
 
@@ -126,8 +145,12 @@ class Entity {
             _scripts.erase(
                 std::remove(_scripts.begin(), _scripts.end(), (void*)script));
         }
+        if constexpr (std::is_same<T, Component::tag>::value)
+            _tagRemoved(get<T>());
+
         _manager.removeComponent<T>(_id);
-        _signature.set(_manager.getComponentTypeID<T>(), false);
+        _signature.set(ComponentManager::getComponentTypeID<T>(), false);
+        _manager.signatureChanged(*this, ComponentManager::getComponentTypeID<T>());
     }
 
     bool operator==(const Entity&) const;
@@ -143,6 +166,9 @@ class Entity {
 
     static std::string idToString(EntityID);
 
+    // parse ID produced by idToString
+    static EntityID idFromString(const std::string&);
+
     void Update();
     void Render();
 
@@ -154,8 +180,16 @@ class Entity {
     Entity(EntityID);
     ~Entity();
 
+    // entities are allocated from a pool instead of the global heap
+    static void* operator new(std::size_t);
+    static void operator delete(void*);
+
     void _init();
-    EntityID _generateID(EntityID, bool g = false) const;
+
+    // keep the tag index of the group up to date
+    void _tagAttached(Component::tag&);
+    void _tagRemoved(const Component::tag&);
+    void _tagRenamed(const std::string& previous, const Component::tag&);
 
    private:
     const EntityID _id;
@@ -168,10 +202,14 @@ class Entity {
     // z-index used when rendering entity
     unsigned int index = 0;
 
-    static std::set<EntityID> takenID;
-    static std::unordered_map<EntityID, Entity*> instances;
+    static EntityAllocator allocator;
+
+    // indexed by entity slot
+    static std::vector<Entity*> instances;
     static bool _cleanFlag;
 
     friend class Group;
-    friend class EventManager;
+    friend class Query;
+    friend class CommandBuffer;
+    friend struct Component::tag;
 };
@@ -9,10 +9,26 @@
 #include "../defs.h"
 #include "../entity/entity.h"
 
+// Component based condition on entity signatures
+struct QueryMask {
+    Signature all;   // required components
+    Signature any;   // at least one of them, ignored if empty
+    Signature none;  // excluded components
+
+    bool matches(const Signature& signature) const {
+        return (signature & all) == all && (signature & none).none() &&
+               (any.none() || (signature & any).any());
+    }
+};
+
 class IFilter {
    public:
     virtual ~IFilter() = default;
     virtual bool filter(EntityID) const = 0;
+
+    // Fill the mask if the filter only depends on components, allowing its
+    // result to be cached. Return false otherwise.
+    virtual bool describe(QueryMask&) const { return false; }
 };
 
 template <typename... TComponents>
@@ -24,6 +40,11 @@ class AllOf : public IFilter {
         if (entity) return entity->all_of<TComponents...>();
         return false;
     }
+
+    bool describe(QueryMask& mask) const override {
+        (mask.all.set(ComponentManager::getComponentTypeID<TComponents>()), ...);
+        return true;
+    }
 };
 
 template <typename... TComponents>
@@ -35,6 +56,11 @@ class NoneOf : public IFilter {
         if (entity) return entity->none_of<TComponents...>();
         return false;
     }
+
+    bool describe(QueryMask& mask) const override {
+        (mask.none.set(ComponentManager::getComponentTypeID<TComponents>()), ...);
+        return true;
+    }
 };
 
 template <typename... TComponents>
@@ -46,6 +72,13 @@ class AnyOf : public IFilter {
         if (entity) return entity->any_of<TComponents...>();
         return false;
     }
+
+    bool describe(QueryMask& mask) const override {
+        // any_of<>() never matches
+        if (!sizeof...(TComponents)) return false;
+        (mask.any.set(ComponentManager::getComponentTypeID<TComponents>()), ...);
+        return true;
+    }
 };
 
 template <typename T>
@@ -57,4 +90,9 @@ class Has : public IFilter {
         if (entity) return entity->has<T>();
         return false;
     }
+
+    bool describe(QueryMask& mask) const override {
+        mask.all.set(ComponentManager::getComponentTypeID<T>());
+        return true;
+    }
 };
\ No newline at end of file
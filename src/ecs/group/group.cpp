@@ -1,25 +1,69 @@
 #include "group.h"
 
 #include <algorithm>
+#include <utility>
 
+#include "../../logger/logger.h"
 #include "../components.h"
 #include "../entity/entity.h"
 
 Group::~Group() {
-    for (auto id : _ids) delete Entity::Get(id);
+    // queries scoped to this group stop being updated
+    if (ComponentManager::instance)
+        ComponentManager::instance->groupDestroyed(this);
+
+    for (auto id : _ids)
+        if (id != NULL_ENTITY) delete Entity::Get(id);
     _ids.clear();
+    _positions.clear();
+}
+
+void Group::_insert(EntityID id) {
+    auto index = entityIndex(id);
+    if (index >= _positions.size()) _positions.resize(index + 1, NPOS);
+
+    _positions[index] = std::uint32_t(_ids.size());
+    _ids.push_back(id);
+}
+
+void Group::_settle() {
+    if (_iterating) return;
+
+    // reorder drops erased entries as well
+    if (_unordered)
+        reorder();
+    else
+        _removeErased();
+}
+
+void Group::_compact() {
+    if (!_iterating) _removeErased();
+}
+
+void Group::_removeErased() {
+    if (!_erased) return;
+
+    _ids.erase(std::remove(_ids.begin(), _ids.end(), NULL_ENTITY), _ids.end());
+    _erased = 0;
+    _reindex();
+}
+
+void Group::_reindex() {
+    for (std::size_t i = 0; i < _ids.size(); ++i)
+        _positions[entityIndex(_ids[i])] = std::uint32_t(i);
 }
 
 Entity& Group::create() {
     auto ret = new Entity;
-    _ids.push_back(*ret);
+    _insert(*ret);
     ret->attach<Component::group>(this);
     return *ret;
 }
 
 Entity& Group::create(EntityID ID) {
+    // ID may be replaced if already taken
     auto ret = new Entity(ID);
-    _ids.push_back(ID);
+    _insert(*ret);
     ret->attach<Component::group>(this);
     return *ret;
 }
@@ -31,24 +75,42 @@ Entity& Group::create(const std::string& tag) {
 }
 
 void Group::erase(EntityID id) {
-    auto it = std::find(_ids.begin(), _ids.end(), id);
-    auto tmp = Entity::Get(*it);
-    delete tmp;
-    _ids.erase(it);
+    auto index = entityIndex(id);
+    if (index >= _positions.size() || _positions[index] == NPOS ||
+        _ids[_positions[index]] != id) {
+        Logger::warn("Group")
+            << Entity::idToString(id) << " does not belong to this group";
+        Logger::endline();
+        return;
+    }
+
+    // leave a hole, iterations in progress keep their positions
+    _ids[_positions[index]] = NULL_ENTITY;
+    _positions[index] = NPOS;
+    ++_erased;
+
+    delete Entity::Get(id);
+
+    // holes are dropped before the next iteration, or once they make up
+    // half of the group so that repeated erasing stays amortized O(1)
+    if (_erased * 2 > _ids.size()) _compact();
 }
 
 void Group::for_each(_process process) {
-    for (auto& id : _ids) {
-        auto tmp = Entity::Get(id);
-        process(*tmp);
-    }
+    _settle();
+    ++_iterating;
+
+    // entities created meanwhile are visited as well
+    for (std::size_t i = 0; i < _ids.size(); ++i)
+        if (_ids[i] != NULL_ENTITY) process(*Entity::Get(_ids[i]));
+
+    --_iterating;
 }
 
 void Group::for_each(_process process, _predicate predicate) {
-    for (auto id : _ids) {
-        auto tmp = Entity::Get(id);
-        if (predicate(*tmp)) process(*tmp);
-    }
+    for_each([&](Entity& entity) {
+        if (predicate(entity)) process(entity);
+    });
 }
 
 std::vector<Entity*> Group::get(_predicate predicate) {
@@ -58,37 +120,98 @@ std::vector<Entity*> Group::get(_predicate predicate) {
 }
 
 Entity* Group::operator[](const std::string& tag) {
-    for (auto id : _ids) {
-        if (auto entity = Entity::Get(id); entity)
-            if (entity->has<Component::tag>())
-                if (entity->get<Component::tag>() == tag) return entity;
+    auto name = InternedString::Find(tag);
+    if (!name.valid()) return nullptr;
+
+    auto it = _tags.find(name);
+    if (it == _tags.end()) return nullptr;
+
+    // several entities may share the tag : first one in iteration order
+    Entity* ret = nullptr;
+    auto position = NPOS;
+    for (auto id : it->second) {
+        auto index = entityIndex(id);
+        if (_positions[index] >= position || _ids[_positions[index]] != id)
+            continue;
+
+        ret = Entity::Get(id);
+        position = _positions[index];
     }
-    return nullptr;
+    return ret;
+}
+
+void Group::_indexTag(EntityID id, const std::string& tag) {
+    auto& ids = _tags[InternedString(tag)];
+    if (std::find(ids.begin(), ids.end(), id) == ids.end()) ids.push_back(id);
+}
+
+void Group::_unindexTag(EntityID id, const std::string& tag) {
+    auto it = _tags.find(InternedString::Find(tag));
+    if (it == _tags.end()) return;
+
+    auto& ids = it->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    if (ids.empty()) _tags.erase(it);
 }
 
 Entity* Group::operator[](EntityID ID) {
-    for (auto id : _ids) {
-        auto e = Entity::Get(ID);
-        if (ID == e->id()) return e;
-    }
-    return nullptr;
+    auto index = entityIndex(ID);
+    if (index >= _positions.size() || _positions[index] == NPOS) return nullptr;
+    if (_ids[_positions[index]] != ID) return nullptr;
+
+    return Entity::Get(ID);
 }
 
+void Group::invalidateOrder() { _unordered = true; }
+
 void Group::reorder() {
-    struct compare {
-        bool operator()(const EntityID& id1, const EntityID& id2) const {
-            return Entity::Get(id1)->index < Entity::Get(id2)->index;
-        }
-    };
-    _ids.sort(compare());
+    _unordered = false;
+    _removeErased();
+
+    // fetch each z-index once instead of on every comparison
+    std::vector<std::pair<unsigned int, EntityID>> keys;
+    keys.reserve(_ids.size());
+    for (auto id : _ids) keys.emplace_back(Entity::Get(id)->index, id);
+
+    std::stable_sort(keys.begin(), keys.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (std::size_t i = 0; i < keys.size(); ++i) _ids[i] = keys[i].second;
+    _reindex();
+    ++_revision;
+}
+
+void Group::reorder(_compare comparator) {
+    _unordered = false;
+    _removeErased();
+
+    std::stable_sort(_ids.begin(), _ids.end(), comparator);
+    _reindex();
+    ++_revision;
 }
 
-void Group::reorder(_compare comparator) { _ids.sort(comparator); }
+void Group::sort(std::vector<Entity*>& entities) const {
+    auto position = [this](const Entity* entity) {
+        auto index = entityIndex(entity->id());
+        return index < _positions.size() ? _positions[index] : NPOS;
+    };
+
+    std::sort(entities.begin(), entities.end(),
+              [&](const Entity* a, const Entity* b) {
+                  return position(a) < position(b);
+              });
+}
 
 std::vector<Entity*> Group::view(const IFilter& filter) {
     std::vector<Entity*> filtered;
-    for (auto id : _ids)
-        if (filter.filter(id)) filtered.push_back(Entity::Get(id));
-
+    view(filter, filtered);
     return filtered;
-}
\ No newline at end of file
+}
+
+void Group::view(const IFilter& filter, std::vector<Entity*>& filtered) {
+    _settle();
+
+    for (auto id : _ids)
+        if (id != NULL_ENTITY && filter.filter(id))
+            filtered.push_back(Entity::Get(id));
+}
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
-#include <list>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../filter/filter.h"
 #include "../defs.h"
+#include "../../util/intern/intern.h"
+#include "../view/view.h"
 
 class Scene;
 class Entity;
@@ -23,6 +27,26 @@ class Group {
     // return a list of entites having required components
     std::vector<Entity*> view(const IFilter& filter);
 
+    // typed view over entities of this group having all of Ts
+    template <typename... Ts>
+    View<Ts...> view() const {
+        return View<Ts...>(this);
+    }
+
+    // apply process(Entity&, Ts&...) or process(Ts&...) to entities of
+    // this group having all of Ts
+    template <typename... Ts, typename F>
+    void each(F&& process) const {
+        view<Ts...>().each(std::forward<F>(process));
+    }
+
+    // same as each, entities are split in ranges processed concurrently
+    // by the job system workers
+    template <typename... Ts, typename F>
+    void parallel_each(F&& process) const {
+        view<Ts...>().parallel_each(std::forward<F>(process));
+    }
+
     // retrieve by tag
     // return null pointer if not found
     Entity* operator[](const std::string&);
@@ -53,14 +77,68 @@ class Group {
     // reorder entities according to entity index
     void reorder();
 
+    // sort by entity index before the next iteration, changes made during
+    // a frame are applied with a single sort
+    void invalidateOrder();
+
     // reorder entites according to the comparator passed as argument
     void reorder(_compare);
 
+    // arrange entities of this group the way for_each visits them,
+    // entities from elsewhere go last
+    void sort(std::vector<Entity*>&) const;
+
+    // append entities passing the filter to the list, in iteration order
+    void view(const IFilter& filter, std::vector<Entity*>&);
+
+    // changes each time entities are reordered, insertions and removals
+    // keep the relative order of the others
+    std::size_t revision() const { return _revision; }
+
    private:
     ~Group();
 
    private:
-    std::list<EntityID> _ids;
+    void _insert(EntityID);
+
+    void _indexTag(EntityID, const std::string&);
+    void _unindexTag(EntityID, const std::string&);
+
+    // apply the pending reorder, or drop erased entries, unless an
+    // iteration is running. The only place sorting is deferred to :
+    // start of an iteration, which is the scene update once per frame,
+    // and start of the systems frame
+    void _settle();
+
+    // drop erased entries unless an iteration is running
+    void _compact();
+
+    void _removeErased();
+
+    // rebuild positions after entries have moved
+    void _reindex();
+
+    static constexpr std::uint32_t NPOS = ~std::uint32_t(0);
+
+    // entities in iteration order, erased entries are NULL_ENTITY until
+    // the next compaction
+    std::vector<EntityID> _ids;
+
+    // position in _ids, indexed by entity slot
+    std::vector<std::uint32_t> _positions;
+
+    std::size_t _erased = 0;
+    int _iterating = 0;
+
+    // an entity index changed since the last sort
+    bool _unordered = false;
+
+    std::size_t _revision = 0;
+
+    // entities holding a tag, maintained on tag attach, rename and removal
+    std::unordered_map<InternedString, std::vector<EntityID>> _tags;
 
     friend class Scene;
+    friend class Entity;
+    friend class SystemManager;
 };
@@ -0,0 +1,74 @@
+#include "query.h"
+
+#include "../components.h"
+#include "../entity/entity.h"
+
+Query::Query(const QueryMask& mask, const Group* scope)
+    : _mask(mask), _scope(scope) {
+    ComponentManager::Get().registerQuery(this);
+
+    // match entities created before the query
+    for (auto entity : Entity::instances)
+        if (entity) _signatureChanged(*entity);
+}
+
+Query::~Query() {
+    if (ComponentManager::instance && !_orphaned)
+        ComponentManager::instance->unregisterQuery(this);
+}
+
+EntityList Query::entities() const { return EntityList(_entities); }
+
+const std::vector<EntityID>& Query::ids() const { return _matched.entities(); }
+
+bool Query::contains(EntityID id) const { return _matched.contains(id); }
+
+std::size_t Query::size() const { return _matched.size(); }
+
+const QueryMask& Query::mask() const { return _mask; }
+
+bool Query::orphaned() const { return _orphaned; }
+
+void Query::_orphan() {
+    _orphaned = true;
+    _scope = nullptr;
+    _matched = SparseSet();
+    _entities.clear();
+    ++_revision;
+}
+
+bool Query::_inScope(Entity& entity) const {
+    if (!_scope) return true;
+    if (!entity.has<Component::group>()) return false;
+    return entity.get<Component::group>().content == _scope;
+}
+
+Signature Query::_components() const {
+    auto components = _mask.all | _mask.any | _mask.none;
+    if (_scope)
+        components.set(ComponentManager::getComponentTypeID<Component::group>());
+    return components;
+}
+
+void Query::_signatureChanged(Entity& entity) {
+    auto id = entity.id();
+    auto matching = _mask.matches(entity._signature) && _inScope(entity);
+    auto present = _matched.contains(id);
+
+    if (matching && !present) {
+        _matched.insert(id);
+        _entities.push_back(&entity);
+        ++_revision;
+    } else if (!matching && present) {
+        _entityDestroyed(id);
+    }
+}
+
+void Query::_entityDestroyed(EntityID id) {
+    auto position = _matched.erase(id);
+    if (position == SparseSet::npos) return;
+
+    _entities[position] = _entities.back();
+    _entities.pop_back();
+    ++_revision;
+}
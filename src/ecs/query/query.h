@@ -0,0 +1,102 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Persistent, incrementally maintained entity queries
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../component/sparse.h"
+#include "../defs.h"
+#include "../filter/filter.h"
+
+class Entity;
+class Group;
+class ComponentManager;
+
+// Read-only access to a list of entities owned by someone else
+class EntityList {
+    const std::vector<Entity*>* _list = nullptr;
+
+   public:
+    using const_iterator = std::vector<Entity*>::const_iterator;
+
+    EntityList() = default;
+    EntityList(const std::vector<Entity*>& list) : _list(&list) {}
+
+    const_iterator begin() const { return _list ? _list->begin() : _empty().begin(); }
+    const_iterator end() const { return _list ? _list->end() : _empty().end(); }
+
+    std::size_t size() const { return _list ? _list->size() : 0; }
+    bool empty() const { return !size(); }
+
+    Entity* operator[](std::size_t i) const { return (*_list)[i]; }
+
+   private:
+    static const std::vector<Entity*>& _empty() {
+        static const std::vector<Entity*> empty;
+        return empty;
+    }
+};
+
+/**
+ * Set of entities matching a component mask
+ *
+ * The query registers itself to the component manager and is updated each
+ * time an entity signature changes, so reading its content costs nothing.
+ * When scoped to a group, only entities created by that group are matched.
+ * Entities are kept in matching order, not in group order.
+ */
+class Query {
+   public:
+    Query(const QueryMask&, const Group* scope = nullptr);
+    ~Query();
+
+    Query(const Query&) = delete;
+    Query& operator=(const Query&) = delete;
+
+    // matched entities
+    EntityList entities() const;
+
+    // IDs of matched entities, parallel to entities()
+    const std::vector<EntityID>& ids() const;
+
+    bool contains(EntityID) const;
+
+    std::size_t size() const;
+
+    const QueryMask& mask() const;
+
+    // scope group was destroyed, the query is empty and no longer updated
+    bool orphaned() const;
+
+    // changes each time an entity is added or removed
+    std::size_t revision() const { return _revision; }
+
+   private:
+    // called by the component manager
+    void _signatureChanged(Entity&);
+    void _entityDestroyed(EntityID);
+
+    bool _inScope(Entity&) const;
+
+    // components whose changes may affect matching, the group one if scoped
+    Signature _components() const;
+
+    void _orphan();
+
+    QueryMask _mask;
+    const Group* _scope;
+
+    SparseSet _matched;
+    std::vector<Entity*> _entities;
+
+    bool _orphaned = false;
+
+    std::size_t _revision = 0;
+
+    friend class ComponentManager;
+};
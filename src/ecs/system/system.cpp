@@ -1,29 +1,158 @@
 #include "system.h"
 
+#include <condition_variable>
+#include <mutex>
+
+#include "../../job/job.h"
+#include "../../scene/scene.h"
 #include "../entity/entity.h"
 #include "../filter/filter.h"
-#include "../../scene/scene.h"
 
 ISystem::ISystem(const std::string& name, IFilter* filter)
-    : _filter(filter), _name(name) {}
+    : _filter(filter), _name(name) {
+    _cached = _filter && _filter->describe(_mask);
+}
 
 ISystem::~ISystem() { delete _filter; }
 
+void ISystem::_prepare(Group& entities) {
+    // storages must exist before workers look them up
+    for (auto prepare : _storages) prepare();
+
+    if (!_cached) return;
+
+    // drop queries of destroyed groups
+    for (auto it = _queries.begin(); it != _queries.end();)
+        if (it->second->orphaned()) {
+            if (it->second.get() == _built) _built = nullptr;
+            it = _queries.erase(it);
+        } else
+            ++it;
+
+    // queries register to the component manager
+    auto& query = _queries[&entities];
+    if (!query) query = std::make_unique<Query>(_mask, &entities);
+}
+
+void ISystem::_collect(Group& entities) {
+    if (!_cached) {
+        _entities.clear();
+        entities.view(*_filter, _entities);
+        return;
+    }
+
+    // the query changes as soon as run() attaches or destroys something,
+    // the list is rebuilt only then or when the group was reordered
+    auto& query = *_queries[&entities];
+    if (_built == &query && _queryRevision == query.revision() &&
+        _groupRevision == entities.revision())
+        return;
+
+    auto list = query.entities();
+    _entities.assign(list.begin(), list.end());
+    entities.sort(_entities);
+
+    _built = &query;
+    _queryRevision = query.revision();
+    _groupRevision = entities.revision();
+}
+
 bool ISystem::performOnEntities(Group& entities) {
-    _entities = entities.view(*_filter);
+    _prepare(entities);
+    _collect(entities);
     return run();
 }
 
+bool ISystem::_conflicts(const ISystem& other) const {
+    if (!_declared || !other._declared) return true;
+
+    return (_writes & (other._reads | other._writes)).any() ||
+           (other._writes & _reads).any();
+}
+
 void SystemManager::run() {
     auto& entities = SceneManager::Get()->getActive().getEntities();
+    auto count = _systems.size();
 
-    for (auto& [name, system] : _systems) {
-        if (!system->performOnEntities(entities)) {
-            Logger::error("System") << name << " failed";
-            Logger::endline();
+    // snapshots follow group order, apply pending sort first
+    entities._settle();
+
+    // dependency graph of this frame
+    std::vector<std::vector<std::size_t>> successors(count);
+    std::vector<std::size_t> pending(count, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        _systems[i]->_prepare(entities);
+        for (std::size_t j = i + 1; j < count; ++j)
+            if (_systems[i]->_conflicts(*_systems[j])) {
+                successors[i].push_back(j);
+                ++pending[j];
+            }
+    }
+
+    std::vector<std::size_t> ready;
+    for (std::size_t i = 0; i < count; ++i)
+        if (!pending[i]) ready.push_back(i);
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t done = 0;
+    std::vector<bool> succeeded(count, true);
+
+    // called with mutex locked
+    auto finish = [&](std::size_t i, bool result) {
+        succeeded[i] = result;
+        ++done;
+        for (auto next : successors[i])
+            if (!--pending[next]) ready.push_back(next);
+        condition.notify_all();
+    };
+
+    auto jobs = JobSystem::Get();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (done < count) {
+        while (!ready.empty()) {
+            auto i = ready.back();
+            ready.pop_back();
+            auto system = _systems[i];
+
+            system->_collect(entities);
+
+            if (system->_declared) {
+                jobs->submit([&, i, system] {
+                    auto result = system->run();
+                    std::lock_guard<std::mutex> guard(mutex);
+                    finish(i, result);
+                });
+            } else {
+                // conflicts with everything, nothing else is running
+                lock.unlock();
+                auto result = system->run();
+                lock.lock();
+                finish(i, result);
+            }
         }
+
+        if (done == count) break;
+
+        // lend the main thread to the workers while systems are running
+        lock.unlock();
+        auto helped = jobs->help();
+        lock.lock();
+
+        if (!helped)
+            condition.wait(lock,
+                           [&] { return done == count || !ready.empty(); });
     }
+    lock.unlock();
+
+    // logger is not thread safe, report from the main thread
+    for (std::size_t i = 0; i < count; ++i)
+        if (!succeeded[i]) {
+            Logger::error("System") << _systems[i]->_name << " failed";
+            Logger::endline();
+        }
 }
 
 // static
-std::shared_ptr<SystemManager> SystemManager::Get() { return createInstance(); }
\ No newline at end of file
+std::shared_ptr<SystemManager> SystemManager::Get() { return createInstance(); }
@@ -6,13 +6,16 @@
 
 #pragma once
 
-#include <map>
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "../../logger/logger.h"
 #include "../../manager/manager.h"
+#include "../component/manager.h"
 #include "../group/group.h"
+#include "../query/query.h"
 
 class SystemManager;
 class Entity;
@@ -22,10 +25,72 @@ class ISystem {
    protected:
     IFilter* _filter;
     std::string _name;
+
+    // entities of the active scene passing the filter, in group order.
+    // Taken before run(), entities created meanwhile are not visited.
+    // With a cached filter the list is only rebuilt when the matched set or
+    // the group order changed : treat it as read-only
     std::vector<Entity*> _entities;
 
     bool performOnEntities(Group& entities);
 
+    /**
+     * Declare components read by run(), to be called in the constructor.
+     *
+     * A system declaring its accesses may run on a worker thread, alongside
+     * systems it doesn't conflict with. It must then only touch declared
+     * components and neither create, destroy, attach nor distach anything.
+     * Their storages are created on the main thread before each frame.
+     * Systems declaring nothing run alone, on the main thread.
+     */
+    template <typename... Ts>
+    void reads() {
+        _declared = true;
+        (_declare<Ts>(_reads), ...);
+    }
+
+    // Declare components modified by run(), see reads()
+    template <typename... Ts>
+    void writes() {
+        _declared = true;
+        (_declare<Ts>(_writes), ...);
+    }
+
+   private:
+    // filters describing a component mask are cached per group in a query,
+    // other filters are evaluated on each entity every frame
+    bool _cached = false;
+    QueryMask _mask;
+    std::unordered_map<const Group*, std::unique_ptr<Query>> _queries;
+
+    // query _entities was built from, and revisions it was built at
+    const Query* _built = nullptr;
+    std::size_t _queryRevision = 0;
+    std::size_t _groupRevision = 0;
+
+    bool _declared = false;
+    Signature _reads;
+    Signature _writes;
+
+    // create storages of declared components, Entity::Clean drops them
+    std::vector<void (*)()> _storages;
+
+    template <typename T>
+    void _declare(Signature& access) {
+        _storages.push_back([] { ComponentManager::Get().prepare<T>(); });
+        access.set(ComponentManager::getComponentTypeID<T>());
+    }
+
+    // main thread setup before run() may be called from a worker
+    void _prepare(Group&);
+
+    // copy matching entities, on the main thread once systems this one
+    // depends on are done
+    void _collect(Group&);
+
+    // check if both systems can't run at the same time
+    bool _conflicts(const ISystem&) const;
+
    public:
     ISystem(const std::string& name, IFilter* filter);
     virtual ~ISystem();
@@ -35,16 +100,20 @@ class ISystem {
 };
 
 class SystemManager : Manager<SystemManager> {
-    std::map<std::string, std::shared_ptr<ISystem>> _systems;
+    // in registration order, which is also the order of conflicting systems
+    std::vector<std::shared_ptr<ISystem>> _systems;
 
     template <typename TSystem>
     void addSystem() {
         auto system = std::make_shared<TSystem>();
         auto message =
             "System with given name " + system->_name + " already exists";
-        assert(_systems.find(system->_name) == _systems.end() &&
+        assert(std::none_of(_systems.begin(), _systems.end(),
+                            [&](const std::shared_ptr<ISystem>& s) {
+                                return s->_name == system->_name;
+                            }) &&
                message.c_str());
-        _systems[system->_name] = system;
+        _systems.push_back(system);
     }
 
    public:
@@ -53,7 +122,12 @@ class SystemManager : Manager<SystemManager> {
         (addSystem<TSystems>(), ...);
     }
 
-    // run systems (TODO : in parallel)
+    /**
+     * Run systems for this frame.
+     * A system depends on every system registered before it which it
+     * conflicts with. Systems without pending dependency are dispatched to
+     * the job system, or run on the main thread when they declared nothing.
+     */
     void run();
 
     static std::shared_ptr<SystemManager> Get();
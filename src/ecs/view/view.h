@@ -0,0 +1,88 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Typed iteration over entities holding a set of components
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../component/manager.h"
+#include "../components.h"
+#include "../entity/entity.h"
+
+class Group;
+
+/**
+ * View over entities holding every component of Ts
+ *
+ * Iteration walks the smallest array among Ts (or the matching archetype
+ * chunks) and hands components by reference, without building a list.
+ * A view built without group covers every entity of every scene.
+ *
+ * group.view<transform, sprite>().each(
+ *     [](Entity& entity, transform& t, sprite& s) { ... });
+ *
+ * Attaching or distaching any of Ts during iteration is not allowed.
+ */
+template <typename... Ts>
+class View {
+    const Group* _scope;
+
+   public:
+    explicit View(const Group* scope = nullptr) : _scope(scope) {}
+
+    // process(Entity&, Ts&...) or process(Ts&...)
+    template <typename F>
+    void each(F&& process) const {
+        if (_scope) {
+            auto scope = _scope;
+            ComponentManager::each<Component::group, Ts...>(
+                [&](EntityID id, Component::group& group, Ts&... components) {
+                    if (group.content == scope)
+                        _call(process, id, components...);
+                });
+        } else {
+            ComponentManager::each<Ts...>([&](EntityID id, Ts&... components) {
+                _call(process, id, components...);
+            });
+        }
+    }
+
+    // same as each, ranges of entities are processed concurrently by the
+    // job system. process must only touch the components it receives.
+    template <typename F>
+    void parallel_each(F&& process) const {
+        if (_scope) {
+            auto scope = _scope;
+            ComponentManager::parallel_each<Component::group, Ts...>(
+                [&](EntityID id, Component::group& group, Ts&... components) {
+                    if (group.content == scope)
+                        _call(process, id, components...);
+                });
+        } else {
+            ComponentManager::parallel_each<Ts...>(
+                [&](EntityID id, Ts&... components) {
+                    _call(process, id, components...);
+                });
+        }
+    }
+
+    // number of entities in the view
+    std::size_t size() const {
+        std::size_t ret = 0;
+        each([&](Ts&...) { ++ret; });
+        return ret;
+    }
+
+   private:
+    template <typename F>
+    static void _call(F& process, EntityID id, Ts&... components) {
+        if constexpr (std::is_invocable<F&, Entity&, Ts&...>::value)
+            process(*Entity::Get(id), components...);
+        else
+            process(components...);
+    }
+};
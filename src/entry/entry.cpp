@@ -7,7 +7,9 @@
 #include <sstream>
 
 #include "../application/application.h"
+#include "../job/job.h"
 #include "../logger/logger.h"
+#include "../pack/assets.h"
 
 int main(int argc, char** argv) {
     Logger::info() << "Creating main application";
@@ -51,6 +53,9 @@ int main(int argc, char** argv) {
         for (auto f : node["Flags"]) flag |= bind[f.as<std::string>()];
     }
 
+    // 0 or missing : one worker per hardware thread but the main one
+    if (node["Workers"]) JobSystem::Configure(node["Workers"].as<std::size_t>());
+
     auto application =
         new Application(title, wSize.x, wSize.y, SDL_WindowFlags(flag));
 
@@ -66,8 +71,13 @@ int main(int argc, char** argv) {
         }
     }
 
+    // assets cooked with ecs-cook, loaders fall back to files when missing
+    auto pack = node["Pack"] ? node["Pack"].as<std::string>() : "assets.pack";
+    if (std::filesystem::exists(configPath / pack)) AssetPack::Get()->open(pack);
+
     auto scenesPath = configPath / "scenes";
-    if (!std::filesystem::exists(scenesPath) && !usingDefaultConfig) {
+    if (!std::filesystem::exists(scenesPath) && !usingDefaultConfig &&
+        !AssetPack::Get()->isOpen()) {
         Logger::warn() << "'scenes' folder not found in '" << configPath;
         Logger::endline();
     }
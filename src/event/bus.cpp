@@ -0,0 +1,60 @@
+#include "bus.h"
+
+std::atomic<std::size_t> EventBus::_nextChannel{0};
+
+namespace Events {
+
+void accumulate(SDL_MouseMotionEvent& pending,
+                const SDL_MouseMotionEvent& latest) {
+    auto xrel = pending.xrel + latest.xrel;
+    auto yrel = pending.yrel + latest.yrel;
+
+    pending = latest;
+    pending.xrel = xrel;
+    pending.yrel = yrel;
+}
+
+void accumulate(SDL_MouseWheelEvent& pending,
+                const SDL_MouseWheelEvent& latest) {
+    auto x = pending.x + latest.x;
+    auto y = pending.y + latest.y;
+
+    pending = latest;
+    pending.x = x;
+    pending.y = y;
+}
+
+}  // namespace Events
+
+EventBus::EventBus() {
+    // high rate input : one event per frame carrying the whole move
+    accumulate<Events::MouseMoved>(
+        [](Events::MouseMoved& pending, const Events::MouseMoved& latest) {
+            Events::accumulate(pending.motion, latest.motion);
+        });
+    accumulate<Events::MouseWheel>(
+        [](Events::MouseWheel& pending, const Events::MouseWheel& latest) {
+            Events::accumulate(pending.wheel, latest.wheel);
+        });
+
+    coalesce<Events::KeyDown>(Coalescing::KEEP_ALL, INPUT_CAPACITY);
+    coalesce<Events::KeyUp>(Coalescing::KEEP_ALL, INPUT_CAPACITY);
+    coalesce<Events::MouseButtonDown>(Coalescing::KEEP_ALL, INPUT_CAPACITY);
+    coalesce<Events::MouseButtonUp>(Coalescing::KEEP_ALL, INPUT_CAPACITY);
+    coalesce<Events::Quit>(Coalescing::KEEP_FIRST);
+}
+
+void EventBus::dispatch() {
+    std::function<void(EventBus&)> posted;
+    while (_posted.pop(posted)) posted(*this);
+
+    // listeners may emit, keep going until every channel is drained
+    for (auto pending = true; pending;) {
+        pending = false;
+        for (std::size_t i = 0; i < _channels.size(); ++i)
+            if (_channels[i] && _channels[i]->dispatch()) pending = true;
+    }
+}
+
+// static
+std::shared_ptr<EventBus> EventBus::Get() { return createInstance(); }
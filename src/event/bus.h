@@ -0,0 +1,313 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Statically typed event channels
+ */
+
+#pragma once
+
+#include <SDL.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../manager/manager.h"
+#include "../util/queue/mpsc.h"
+
+class Scene;
+
+/**
+ * How an event is merged with pending ones of the same kind, i.e. emitted
+ * since the last dispatch
+ */
+enum class Coalescing {
+    // drop the new event, the pending one is delivered
+    KEEP_FIRST,
+
+    // the new event replaces the pending one
+    KEEP_LATEST,
+
+    // the new event is merged into the pending one (e.g. motion deltas)
+    ACCUMULATE,
+
+    // every event is delivered, the oldest ones are dropped past capacity
+    KEEP_ALL
+};
+
+// pending key and button events kept per frame, by both the EventManager
+// and the EventBus
+constexpr std::size_t INPUT_CAPACITY = 64;
+
+// Typed counterparts of the engine events
+namespace Events {
+
+// sum relative motion, keep latest position and state
+void accumulate(SDL_MouseMotionEvent& pending, const SDL_MouseMotionEvent& latest);
+
+// sum scrolled amount
+void accumulate(SDL_MouseWheelEvent& pending, const SDL_MouseWheelEvent& latest);
+
+struct Quit {};
+
+struct KeyDown {
+    SDL_KeyboardEvent key;
+};
+
+struct KeyUp {
+    SDL_KeyboardEvent key;
+};
+
+struct MouseButtonDown {
+    SDL_MouseButtonEvent button;
+};
+
+struct MouseButtonUp {
+    SDL_MouseButtonEvent button;
+};
+
+struct MouseMoved {
+    SDL_MouseMotionEvent motion;
+};
+
+struct MouseWheel {
+    SDL_MouseWheelEvent wheel;
+};
+
+struct SceneLoaded {
+    Scene* scene;
+};
+
+struct SceneChanged {};
+
+}  // namespace Events
+
+/**
+ * Event bus where each event type has its own channel
+ *
+ * Any type can be an event, no string nor payload lookup is involved :
+ * the channel of T is found through an index assigned to T on first use.
+ * Events are queued and delivered, by value, during EventManager::handle.
+ *
+ * auto bus = EventBus::Get();
+ * auto id = bus->listen<Events::MouseMoved>([](const Events::MouseMoved& e) {
+ *     ...
+ * });
+ * bus->emit<Events::MouseMoved>(motion);
+ * bus->stopListening<Events::MouseMoved>(id);
+ *
+ * EventListner::listen<T> ties the subscription to the listener lifetime.
+ *
+ * Only post is thread safe : every other call, which may create a channel,
+ * must be made on the main thread.
+ */
+class EventBus : Manager<EventBus> {
+    class IChannel {
+       public:
+        virtual ~IChannel() = default;
+
+        // deliver queued events, false if there was none
+        virtual bool dispatch() = 0;
+
+        virtual void unsubscribe(std::size_t id) = 0;
+    };
+
+    template <typename T>
+    class Channel : public IChannel {
+       public:
+        using Callback = std::function<void(const T&)>;
+
+        std::size_t subscribe(Callback callback) {
+            _listeners.push_back({_nextID, std::make_shared<Callback>(
+                                               std::move(callback))});
+            return _nextID++;
+        }
+
+        void unsubscribe(std::size_t id) override {
+            for (auto& listener : _listeners)
+                if (listener.id == id) listener.callback.reset();
+            _compact();
+        }
+
+        template <typename... TArgs>
+        void push(TArgs&&... args) {
+            if (_listeners.empty()) return;
+
+            T event{std::forward<TArgs>(args)...};
+            if (_pending.empty() || _policy == Coalescing::KEEP_ALL) {
+                _pending.push_back(std::move(event));
+
+                // bounded, keep the most recent ones
+                if (_capacity && _pending.size() > _capacity)
+                    _pending.pop_front();
+                return;
+            }
+
+            switch (_policy) {
+                case Coalescing::KEEP_LATEST:
+                    _pending.back() = std::move(event);
+                    break;
+                case Coalescing::ACCUMULATE:
+                    if (_merge)
+                        _merge(_pending.back(), event);
+                    else
+                        _pending.back() = std::move(event);
+                    break;
+                default:;
+            }
+        }
+
+        void coalesce(Coalescing policy, std::size_t capacity) {
+            _policy = policy;
+            _capacity = capacity;
+        }
+
+        void accumulate(std::function<void(T&, const T&)> merge) {
+            _policy = Coalescing::ACCUMULATE;
+            _merge = std::move(merge);
+        }
+
+        bool dispatch() override {
+            if (_pending.empty()) return false;
+
+            // events emitted by listeners are delivered on the next pass
+            std::deque<T> events;
+            events.swap(_pending);
+
+            ++_dispatching;
+            for (auto& event : events)
+                for (std::size_t i = 0; i < _listeners.size(); ++i)
+                    if (auto callback = _listeners[i].callback; callback)
+                        (*callback)(event);
+            --_dispatching;
+
+            _compact();
+            return true;
+        }
+
+        bool empty() const { return _listeners.empty(); }
+
+       private:
+        void _compact() {
+            if (_dispatching) return;
+
+            std::vector<Listener> listeners;
+            for (auto& listener : _listeners)
+                if (listener.callback) listeners.push_back(listener);
+            _listeners.swap(listeners);
+        }
+
+        struct Listener {
+            std::size_t id;
+
+            // null once unsubscribed
+            std::shared_ptr<Callback> callback;
+        };
+
+        std::vector<Listener> _listeners;
+        std::deque<T> _pending;
+
+        Coalescing _policy = Coalescing::KEEP_ALL;
+
+        // 0 : unbounded
+        std::size_t _capacity = 0;
+
+        std::function<void(T&, const T&)> _merge;
+        std::size_t _nextID = 0;
+        int _dispatching = 0;
+    };
+
+   public:
+    // queue an event of type T, built from args
+    // dropped right away when nobody listens to T
+    template <typename T, typename... TArgs>
+    void emit(TArgs&&... args) {
+        _channel<T>().push(std::forward<TArgs>(args)...);
+    }
+
+    // queue an event from any thread, emitted on the main thread at the
+    // beginning of the next dispatch
+    template <typename T, typename... TArgs>
+    void post(TArgs&&... args) {
+        _posted.push([event = T{std::forward<TArgs>(args)...}](
+                         EventBus& bus) mutable { bus.emit<T>(std::move(event)); });
+    }
+
+    /**
+     * Set how events of type T emitted before the next dispatch are merged.
+     * Default : KEEP_ALL, unbounded. ACCUMULATE without merge function
+     * behaves like KEEP_LATEST.
+     * @param capacity maximum of pending events with KEEP_ALL, 0 : unbounded,
+     * same as EventManager::coalesce
+     */
+    template <typename T>
+    void coalesce(Coalescing policy, std::size_t capacity = 0) {
+        _channel<T>().coalesce(policy, capacity);
+    }
+
+    // merge pending events of type T with merge(pending, latest)
+    template <typename T>
+    void accumulate(std::function<void(T& pending, const T& latest)> merge) {
+        _channel<T>().accumulate(std::move(merge));
+    }
+
+    // return an ID used to stop listening
+    template <typename T>
+    std::size_t listen(std::function<void(const T&)> callback) {
+        return _channel<T>().subscribe(std::move(callback));
+    }
+
+    template <typename T>
+    void stopListening(std::size_t id) {
+        _channel<T>().unsubscribe(id);
+    }
+
+    // check if an event of type T would be delivered to someone
+    template <typename T>
+    bool listened() {
+        return !_channel<T>().empty();
+    }
+
+    // deliver queued events of every channel
+    void dispatch();
+
+    static std::shared_ptr<EventBus> Get();
+
+   private:
+    EventBus();
+
+    template <typename T>
+    Channel<T>& _channel() {
+        static const std::size_t index = _nextChannel++;
+
+        // _channels isn't guarded, workers go through post
+        assert(std::this_thread::get_id() == _mainThread &&
+               "EventBus channels are only used on the main thread");
+
+        if (index >= _channels.size()) _channels.resize(index + 1);
+        if (!_channels[index]) _channels[index] = std::make_unique<Channel<T>>();
+
+        return static_cast<Channel<T>&>(*_channels[index]);
+    }
+
+    // indexed by the channel index of the event type
+    std::vector<std::unique_ptr<IChannel>> _channels;
+
+    // events posted from other threads
+    MPSCQueue<std::function<void(EventBus&)>> _posted;
+
+    // thread creating the bus, the one dispatching it
+    std::thread::id _mainThread = std::this_thread::get_id();
+
+    // channel indices are shared by every bus
+    static std::atomic<std::size_t> _nextChannel;
+
+    friend class EventListner;
+    friend class Manager<EventBus>;
+};
@@ -1,124 +1,298 @@
 #include "event.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <iterator>
 #include <map>
 
 #include "../application/application.h"
-#include "../ecs/ecs.h"
 #include "input.h"
 
+EventManager::EventManager() {
+    // high rate input : one event per frame carrying the whole move
+    coalesce(Input.MOUSE_MOTION, Coalescing::ACCUMULATE);
+    coalesce(Input.MOUSE_WHEEL, Coalescing::ACCUMULATE);
+
+    // presses must not be lost
+    coalesce(Input.KEY_DOWN, Coalescing::KEEP_ALL, INPUT_CAPACITY);
+    coalesce(Input.KEY_UP, Coalescing::KEEP_ALL, INPUT_CAPACITY);
+    coalesce(Input.MOUSE_BUTTON_DOWN, Coalescing::KEEP_ALL, INPUT_CAPACITY);
+    coalesce(Input.MOUSE_BUTTON_UP, Coalescing::KEEP_ALL, INPUT_CAPACITY);
+}
+
 EventManager::~EventManager() {
-    while (!events.empty()) {
-        delete events.front();
-        events.pop();
-    }
+    events.clear();
     bind.clear();
-    listners.clear();
+    _subscriptions.clear();
 }
 
 void EventManager::handle() {
     SDLEvents();
-    while (!events.empty()) {
-        Event& event = events.front();
-        auto tag = event->get<Component::tag>().content;
-
-        for (int i = 0; i < (int)listners.size(); ++i) {
-            auto& listener = *listners[i];
-            if (listener.enabled) {
-                auto& callbacks = listener.callbacks;
-                if (callbacks.find(tag) != callbacks.end()) {
-                    auto& callback = callbacks[tag];
-                    if (callback.withParameter) {
-                        auto& function = *callback.function;
-                        function(*event);
-                    } else {
-                        auto& function = *callback.noParamFunction;
-                        function();
-                    }
-                }
-            }
+    _drainPosted();
+
+    ++_dispatching;
+
+    // listeners may emit while dispatching, those events are handled as well
+    for (std::size_t index = 0; index < _count; ++index) {
+        Event& event = events[index];
+
+        // emitting this name again creates a new event
+        bind.erase(event.name());
+
+        if (auto it = _policies.find(event.name()); it != _policies.end()) {
+            auto& pending = it->second.pending;
+            if (!pending.empty() && pending.front() == index)
+                pending.pop_front();
         }
 
-        delete event;
-        events.pop();
-        bind.erase(tag);
+        if (event._dropped) continue;
+
+        auto it = _subscriptions.find(event.name());
+        if (it == _subscriptions.end()) continue;
+        auto& subscriptions = it->second;
+
+        // subscriptions made meanwhile are appended and called as well
+        for (std::size_t i = 0; i < subscriptions.size(); ++i) {
+            auto subscription = subscriptions[i];
+            if (subscription.listener && subscription.listener->enabled)
+                (*subscription.callback)(event);
+        }
+    }
+
+    --_dispatching;
+
+    // records are kept for the next frame, payloads are released
+    for (std::size_t index = 0; index < _count; ++index)
+        events[index]._payload = std::monostate();
+    _highWater = std::max(_highWater, _count);
+    _count = 0;
+
+    // a burst of input doesn't keep its records for the rest of the run :
+    // trim to the peak of the last frames once in a while
+    if (++_frames == TRIM_FRAMES) {
+        if (events.size() > _highWater) {
+            events.erase(events.begin() + _highWater, events.end());
+            events.shrink_to_fit();
+        }
+        _highWater = 0;
+        _frames = 0;
     }
+    for (auto& [name, policy] : _policies) policy.pending.clear();
+    _compact();
+
+    EventBus::Get()->dispatch();
 }
 
 void EventManager::SDLEvents() {
+    auto bus = EventBus::Get();
+
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
             case SDL_QUIT:
                 _emit(Input.QUIT);
+                bus->emit<Events::Quit>();
                 break;
             case SDL_KEYDOWN:
-                _emit(Input.KEY_DOWN).attachIf<SDL_KeyboardEvent>(event.key);
+                _input(Input.KEY_DOWN, event.key);
+                bus->emit<Events::KeyDown>(event.key);
                 Input.keys[event.key.keysym.scancode] = true;
                 break;
             case SDL_KEYUP:
-                _emit(Input.KEY_UP).attachIf<SDL_KeyboardEvent>(event.key);
+                _input(Input.KEY_UP, event.key);
+                bus->emit<Events::KeyUp>(event.key);
                 Input.keys[event.key.keysym.scancode] = false;
                 break;
             case SDL_MOUSEBUTTONDOWN:
-                _emit(Input.MOUSE_BUTTON_DOWN)
-                    .attachIf<SDL_MouseButtonEvent>(event.button);
+                _input(Input.MOUSE_BUTTON_DOWN, event.button);
+                bus->emit<Events::MouseButtonDown>(event.button);
                 break;
             case SDL_MOUSEBUTTONUP:
-                _emit(Input.MOUSE_BUTTON_UP)
-                    .attachIf<SDL_MouseButtonEvent>(event.button);
+                _input(Input.MOUSE_BUTTON_UP, event.button);
+                bus->emit<Events::MouseButtonUp>(event.button);
                 break;
             case SDL_MOUSEMOTION:
-                _emit(Input.MOUSE_MOTION)
-                    .attachIf<SDL_MouseMotionEvent>(event.motion);
+                _input(Input.MOUSE_MOTION, event.motion);
+                bus->emit<Events::MouseMoved>(event.motion);
                 break;
             case SDL_MOUSEWHEEL:
-                _emit(Input.MOUSE_WHEEL)
-                    .attachIf<SDL_MouseWheelEvent>(event.wheel);
+                _input(Input.MOUSE_WHEEL, event.wheel);
+                bus->emit<Events::MouseWheel>(event.wheel);
                 break;
             default:;
         }
     }
 }
 
-Entity& EventManager::emit(const std::string& event_name) {
-    std::vector<std::string> reserved = {Input.QUIT,
-                                         Input.KEY_DOWN,
-                                         Input.KEY_UP,
-                                         Input.MOUSE_BUTTON_DOWN,
-                                         Input.MOUSE_BUTTON_UP,
-                                         Input.MOUSE_WHEEL,
-                                         Input.MOUSE_MOTION,
-                                         Input.SCENE_LOADED,
-                                         Input.SCENE_CHANGED};
+Event& EventManager::emit(const std::string& event_name) {
+    _checkReserved(event_name);
+    return _emit(event_name);
+}
+
+void EventManager::post(const std::string& event_name) {
+    post(InternedString(event_name));
+}
 
-    auto invalidEvent = std::find(reserved.begin(), reserved.end(),
-                                  event_name) != reserved.end();
+void EventManager::post(InternedString event_name) {
+    _checkReserved(event_name);
+    _posted.push(Event(event_name));
+}
+
+// static
+void EventManager::_checkReserved(const std::string& event_name) {
+    static const std::vector<std::string> reserved = {Input.QUIT,
+                                                      Input.KEY_DOWN,
+                                                      Input.KEY_UP,
+                                                      Input.MOUSE_BUTTON_DOWN,
+                                                      Input.MOUSE_BUTTON_UP,
+                                                      Input.MOUSE_WHEEL,
+                                                      Input.MOUSE_MOTION,
+                                                      Input.SCENE_LOADED,
+                                                      Input.SCENE_CHANGED};
+
+    auto reservedEvent = std::find(reserved.begin(), reserved.end(),
+                                   event_name) != reserved.end();
     auto message = "You can not emit event : " + event_name;
-    assert(invalidEvent && message.c_str());
+    assert(!reservedEvent && message.c_str());
+}
 
-    return _emit(event_name);
+// static
+void EventManager::_checkReserved(InternedString event_name) {
+    // interned once, then compared as integers
+    static const InternedString reserved[] = {
+        InternedString(Input.QUIT),
+        InternedString(Input.KEY_DOWN),
+        InternedString(Input.KEY_UP),
+        InternedString(Input.MOUSE_BUTTON_DOWN),
+        InternedString(Input.MOUSE_BUTTON_UP),
+        InternedString(Input.MOUSE_WHEEL),
+        InternedString(Input.MOUSE_MOTION),
+        InternedString(Input.SCENE_LOADED),
+        InternedString(Input.SCENE_CHANGED)};
+
+    auto reservedEvent = std::find(std::begin(reserved), std::end(reserved),
+                                   event_name) != std::end(reserved);
+    assert(!reservedEvent && "You can not emit an engine event");
+    (void)reservedEvent;
+}
+
+Coalescing EventManager::_policy(InternedString name) const {
+    auto it = _policies.find(name);
+    return it == _policies.end() ? Coalescing::KEEP_FIRST : it->second.mode;
+}
+
+void EventManager::_drainPosted() {
+    Event posted{InternedString()};
+    while (_posted.pop(posted)) {
+        auto& event = _emit(posted.name());
+        auto policy = _policy(posted.name());
+
+        if (policy == Coalescing::KEEP_FIRST &&
+            !std::holds_alternative<std::monostate>(event._payload))
+            continue;
+
+        if (policy == Coalescing::ACCUMULATE) {
+            if (event.has<SDL_MouseMotionEvent>() &&
+                posted.has<SDL_MouseMotionEvent>()) {
+                Events::accumulate(event.get<SDL_MouseMotionEvent>(),
+                                   posted.get<SDL_MouseMotionEvent>());
+                continue;
+            }
+            if (event.has<SDL_MouseWheelEvent>() &&
+                posted.has<SDL_MouseWheelEvent>()) {
+                Events::accumulate(event.get<SDL_MouseWheelEvent>(),
+                                   posted.get<SDL_MouseWheelEvent>());
+                continue;
+            }
+        }
+
+        event._payload = std::move(posted._payload);
+    }
+}
+
+void EventManager::coalesce(const std::string& event_name, Coalescing mode,
+                            std::size_t capacity) {
+    auto& policy = _policies[InternedString(event_name)];
+    policy.mode = mode;
+    policy.capacity = capacity;
+}
+
+Event& EventManager::_emit(const std::string& event_name) {
+    return _emit(InternedString(event_name));
 }
 
-Entity& EventManager::_emit(const std::string& event_name) {
-    if (bind.find(event_name) != bind.end()) return *bind[event_name];
+Event& EventManager::_emit(InternedString name) {
+    auto policy = _policies.find(name);
+    if (policy == _policies.end() || policy->second.mode != Coalescing::KEEP_ALL) {
+        if (auto it = bind.find(name); it != bind.end())
+            return events[it->second];
+
+        bind[name] = _count;
+        return _record(name);
+    }
+
+    // bounded : the oldest pending event is skipped
+    if (policy->second.capacity) {
+        auto& pending = policy->second.pending;
+        pending.push_back(_count);
+        if (pending.size() > policy->second.capacity) {
+            events[pending.front()]._dropped = true;
+            pending.pop_front();
+        }
+    }
 
-    Event event = new Entity;
-    event->attach<Component::tag>(event_name);
+    return _record(name);
+}
 
-    bind[event_name] = event;
-    events.push(event);
+Event& EventManager::_record(InternedString name) {
+    if (_count < events.size())
+        events[_count] = Event(name);
+    else
+        events.emplace_back(name);
 
-    return *event;
+    return events[_count++];
 }
 
-void EventManager::newListner(EventListner* listner) {
-    listners.push_back(listner);
+void EventManager::_subscribe(EventListner* listener, InternedString name,
+                              std::function<void(Event&)> callback) {
+    _unsubscribe(listener, name);
+    _subscriptions[name].push_back(
+        {listener, std::make_shared<std::function<void(Event&)>>(
+                       std::move(callback))});
 }
 
-void EventManager::listnerDestroyed(EventListner* listner) {
-    listners.erase(std::remove(listners.begin(), listners.end(), listner));
+void EventManager::_unsubscribe(EventListner* listener, InternedString name) {
+    auto it = _subscriptions.find(name);
+    if (it == _subscriptions.end()) return;
+
+    for (auto& subscription : it->second)
+        if (subscription.listener == listener) {
+            subscription.listener = nullptr;
+            _unsubscribed = true;
+        }
+
+    _compact();
+}
+
+void EventManager::_compact() {
+    if (_dispatching || !_unsubscribed) return;
+    _unsubscribed = false;
+
+    for (auto it = _subscriptions.begin(); it != _subscriptions.end();) {
+        auto& subscriptions = it->second;
+        subscriptions.erase(
+            std::remove_if(subscriptions.begin(), subscriptions.end(),
+                           [](const Subscription& subscription) {
+                               return !subscription.listener;
+                           }),
+            subscriptions.end());
+
+        if (subscriptions.empty())
+            it = _subscriptions.erase(it);
+        else
+            ++it;
+    }
 }
 
 // static
-std::shared_ptr<EventManager> EventManager::Get() { return createInstance(); }
\ No newline at end of file
+std::shared_ptr<EventManager> EventManager::Get() { return createInstance(); }
@@ -8,66 +8,283 @@
 
 #include <SDL.h>
 
-#include <optional>
+#include <any>
+#include <cassert>
+#include <deque>
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
-#include <queue>
+#include <optional>
 #include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
+#include "../logger/logger.h"
 #include "../manager/manager.h"
+#include "../util/intern/intern.h"
+#include "../util/queue/mpsc.h"
+#include "bus.h"
 #include "input.h"
 
 class Entity;
+class Scene;
 class EventListner;
 
-class EventManager : Manager<EventManager> {
+/**
+ * Event record, stored by value in the event queue
+ *
+ * The payload is one of the types carried by the engine's own events, or
+ * any other type through std::any.
+ *
+ * EventManager::Get()->emit("hit").attach<int>(damage);
+ *
+ * listener.listen("hit", [](Event& event) {
+ *     if (event.has<int>()) health -= event.get<int>();
+ * });
+ *
+ * Events used to be entities : callbacks taking an Entity& must now take an
+ * Event&, which keeps the has/get/attach calls. The tag component is
+ * replaced by tag(). This break is intended, see CHANGELOG.md.
+ */
+class Event {
    public:
-    using Event = Entity*;
+    using Payload =
+        std::variant<std::monostate, SDL_KeyboardEvent, SDL_MouseButtonEvent,
+                     SDL_MouseMotionEvent, SDL_MouseWheelEvent, Scene*,
+                     std::any>;
+
+    explicit Event(InternedString name) : _name(name) {}
+
+    // name the event was emitted with
+    const std::string& tag() const { return _name.str(); }
+
+    InternedString name() const { return _name; }
+
+    template <typename T>
+    bool has() const {
+        if constexpr (_stored<T>())
+            return std::holds_alternative<T>(_payload);
+        else
+            return std::holds_alternative<std::any>(_payload) &&
+                   std::any_cast<T>(&std::get<std::any>(_payload));
+    }
+
+    template <typename T>
+    T& get() {
+        T* payload = nullptr;
+        if constexpr (_stored<T>())
+            payload = std::get_if<T>(&_payload);
+        else if (auto any = std::get_if<std::any>(&_payload); any)
+            payload = std::any_cast<T>(any);
+
+        if (!payload) {
+            Logger::error("Event") << "Can not retrieve '" << typeid(T).name()
+                                   << "' on event " << tag();
+            Logger::endline();
+        }
+
+        assert(payload && "Retrieving non-existent event payload");
 
+        return *payload;
+    }
+
+    // replace payload
+    template <typename T, typename... TArgs>
+    T& attach(TArgs&&... args) {
+        if constexpr (_stored<T>())
+            return _payload.emplace<T>(std::forward<TArgs>(args)...);
+        else {
+            if (!std::holds_alternative<std::any>(_payload))
+                _payload.emplace<std::any>();
+            return std::get<std::any>(_payload).emplace<T>(
+                std::forward<TArgs>(args)...);
+        }
+    }
+
+    // attach payload if event doesn't have one of this type
+    template <typename T, typename... TArgs>
+    T& attachIf(TArgs&&... args) {
+        if (has<T>()) return get<T>();
+        return attach<T>(std::forward<TArgs>(args)...);
+    }
+
+   private:
+    // pushed out of a full KEEP_ALL queue, not delivered
+    bool _dropped = false;
+
+    // T is one of the payload alternatives
+    template <typename T>
+    static constexpr bool _stored() {
+        return _alternative<T>(std::make_index_sequence<
+                               std::variant_size<Payload>::value - 1>());
+    }
+
+    template <typename T, std::size_t... Is>
+    static constexpr bool _alternative(std::index_sequence<Is...>) {
+        return (std::is_same<T, std::variant_alternative_t<Is, Payload>>::value ||
+                ...);
+    }
+
+    InternedString _name;
+    Payload _payload;
+
+    friend class EventManager;
+};
+
+class EventManager : Manager<EventManager> {
+   public:
     void handle();
 
-    // Emit this message and attach as a tag to an entity
+    // Emit this message, the returned event carries its payload
     // Use an EventListner instance to listent to this event anywhere
-    Entity& emit(const std::string&);
+    Event& emit(const std::string&);
+
+    /**
+     * Emit from any thread, the event is handed to the main thread and
+     * emitted at the beginning of the next handle call.
+     * The string overloads intern the name, which locks : producers should
+     * intern it once and post with the InternedString overloads.
+     * The manager is created by the Application before any worker starts,
+     * call Get on the main thread first when posting without one.
+     *
+     * static const InternedString hit("hit");
+     * EventManager::Get()->post(hit, damage);
+     */
+    void post(const std::string&);
+    void post(InternedString);
+
+    // Emit from any thread with a payload
+    template <typename T>
+    void post(const std::string& event_name, T&& payload) {
+        post(InternedString(event_name), std::forward<T>(payload));
+    }
+
+    template <typename T>
+    void post(InternedString event_name, T&& payload) {
+        _checkReserved(event_name);
+
+        Event event{event_name};
+        event.attach<std::decay_t<T>>(std::forward<T>(payload));
+        _posted.push(std::move(event));
+    }
+
+    /**
+     * Set how events emitted with this name while one is pending are merged.
+     * Default : KEEP_FIRST, emit returns the pending event.
+     * ACCUMULATE applies to engine input payloads, custom events behave
+     * like with KEEP_LATEST : emit returns the pending event to update.
+     * @param capacity maximum of pending events with KEEP_ALL, 0 : unbounded,
+     * same as EventBus::coalesce
+     */
+    void coalesce(const std::string&, Coalescing, std::size_t capacity = 0);
 
     static std::shared_ptr<EventManager> Get();
 
    private:
-    Entity& _emit(const std::string&);
+    Event& _emit(const std::string&);
+    Event& _emit(InternedString);
+
+    // next pending record, reused when available
+    Event& _record(InternedString);
     void SDLEvents();
 
-    std::queue<Event> events;
-    std::vector<EventListner*> listners;
-    std::unordered_map<std::string, Event> bind;
+    // assert the name isn't one of the engine events
+    static void _checkReserved(const std::string&);
+
+    // same, without locking the intern table
+    static void _checkReserved(InternedString);
+
+    Coalescing _policy(InternedString) const;
+
+    // emit events posted from other threads
+    void _drainPosted();
+
+    // emit an engine input event, merged according to its policy
+    template <typename T>
+    void _input(const std::string& name, const T& payload) {
+        auto& event = _emit(name);
+        auto policy = _policy(event.name());
+
+        if (policy == Coalescing::KEEP_FIRST)
+            event.attachIf<T>(payload);
+        else if constexpr (std::is_same<T, SDL_MouseMotionEvent>::value ||
+                           std::is_same<T, SDL_MouseWheelEvent>::value) {
+            if (policy == Coalescing::ACCUMULATE && event.has<T>())
+                Events::accumulate(event.get<T>(), payload);
+            else
+                event.attach<T>(payload);
+        } else
+            event.attach<T>(payload);
+    }
+
+    struct Policy {
+        Coalescing mode;
+
+        // 0 : unbounded
+        std::size_t capacity;
+
+        // positions of pending events, for KEEP_ALL
+        std::deque<std::size_t> pending;
+    };
+
+    std::unordered_map<InternedString, Policy> _policies;
+
+    // filled by any thread, drained by handle
+    MPSCQueue<Event> _posted;
 
-    // std::vector<EventListner*> toAdd;
-    // std::vector<EventListner*> toRemove;
+    // pending events, references stay valid while emitting
+    // records are reused from frame to frame, the first _count are pending
+    std::deque<Event> events;
+    std::size_t _count = 0;
 
-    void listnerDestroyed(EventListner*);
-    void newListner(EventListner*);
+    // most events pending at once since the last trim of records
+    std::size_t _highWater = 0;
+    std::size_t _frames = 0;
+    static constexpr std::size_t TRIM_FRAMES = 120;
 
-    EventManager() = default;
+    // position in events of the pending event with this name
+    std::unordered_map<InternedString, std::size_t> bind;
+
+    struct Subscription {
+        // null once unsubscribed, removed after dispatch
+        EventListner* listener;
+
+        // shared so that it survives unsubscribing from inside itself
+        std::shared_ptr<std::function<void(Event&)>> callback;
+    };
+
+    // subscriptions to each event, in subscription order
+    std::unordered_map<InternedString, std::vector<Subscription>> _subscriptions;
+
+    int _dispatching = 0;
+    bool _unsubscribed = false;
+
+    // replace the listener's subscription to the event, if any
+    void _subscribe(EventListner*, InternedString,
+                    std::function<void(Event&)>);
+    void _unsubscribe(EventListner*, InternedString);
+
+    // drop subscriptions cancelled while dispatching
+    void _compact();
+
+    EventManager();
     ~EventManager();
 
     friend class EventListner;
+    friend class SceneManager;
     friend class Manager<EventManager>;
 };
 
 // Use this class to handle specific event.
 class EventListner {
-    using WithParameter = std::function<void(Entity&)>;
+    using WithParameter = std::function<void(Event&)>;
     using WithoutParameter = std::function<void()>;
 
-    struct Callback {
-        bool withParameter = true;
-        std::optional<WithParameter> function;
-        std::optional<WithoutParameter> noParamFunction;
-    };
-
    public:
     EventListner();
     ~EventListner();
@@ -78,6 +295,31 @@ class EventListner {
     // provide event's tag and function callback
     EventListner& listen(const std::string&, const WithoutParameter&);
 
+    // callbacks taking an Entity& predate event records and are rejected on
+    // purpose, see Event
+    template <typename F,
+              std::enable_if_t<std::is_invocable<F, Entity&>::value &&
+                                   !std::is_invocable<F, Event&>::value,
+                               int> = 0>
+    EventListner& listen(const std::string&, F&&) {
+        static_assert(!std::is_invocable<F, Entity&>::value,
+                      "Event callbacks take an Event& instead of an Entity&, "
+                      "it provides the same has/get/attach calls, see "
+                      "CHANGELOG.md");
+        return *this;
+    }
+
+    // listen to events of type T emitted on the EventBus
+    template <typename T>
+    EventListner& listen(std::function<void(const T&)> callback) {
+        auto bus = EventBus::Get();
+        auto id = bus->listen<T>([this, callback](const T& event) {
+            if (enabled) callback(event);
+        });
+        channels.push_back({&bus->_channel<T>(), id});
+        return *this;
+    }
+
     // stop listening to the event with the given tag
     void stopListening(const std::string&);
 
@@ -92,8 +334,13 @@ class EventListner {
 
    private:
     std::shared_ptr<EventManager> manager;
-    std::map<std::string, Callback> callbacks;
+
+    // events this listener subscribed to
+    std::vector<InternedString> events;
+
+    // typed subscriptions, channel and ID
+    std::vector<std::pair<EventBus::IChannel*, std::size_t>> channels;
     bool enabled = true;
 
     friend class EventManager;
-};
\ No newline at end of file
+};
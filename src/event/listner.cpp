@@ -1,38 +1,42 @@
 #include "event.h"
 
-EventListner::EventListner() {
-    manager = EventManager::Get();
-    manager->newListner(this);
-}
+#include <algorithm>
+
+EventListner::EventListner() { manager = EventManager::Get(); }
 
-EventListner::~EventListner() { manager->listnerDestroyed(this); }
+EventListner::~EventListner() { removeCallbacks(); }
 
 EventListner& EventListner::listen(const std::string& event,
                                    const WithParameter& callback) {
-    Callback callbackRecord;
-    callbackRecord.withParameter = true;
-    callbackRecord.function = callback;
+    InternedString name(event);
+    if (std::find(events.begin(), events.end(), name) == events.end())
+        events.push_back(name);
 
-    callbacks[event] = callbackRecord;
+    manager->_subscribe(this, name, callback);
     return *this;
 }
 
 EventListner& EventListner::listen(const std::string& event,
                                    const WithoutParameter& callback) {
-    Callback callbackRecord;
-    callbackRecord.withParameter = false;
-    callbackRecord.noParamFunction = callback;
-
-    callbacks[event] = callbackRecord;
-    return *this;
+    return listen(event, WithParameter([callback](Event&) { callback(); }));
 }
 
 void EventListner::stopListening(const std::string& event) {
-    callbacks.erase(event);
+    auto name = InternedString::Find(event);
+    if (!name.valid()) return;
+
+    events.erase(std::remove(events.begin(), events.end(), name), events.end());
+    manager->_unsubscribe(this, name);
 }
 
-void EventListner::removeCallbacks() { callbacks.clear(); }
+void EventListner::removeCallbacks() {
+    for (auto name : events) manager->_unsubscribe(this, name);
+    events.clear();
+
+    for (auto [channel, id] : channels) channel->unsubscribe(id);
+    channels.clear();
+}
 
 void EventListner::enable() { enabled = true; }
 
-void EventListner::disable() { enabled = false; }
\ No newline at end of file
+void EventListner::disable() { enabled = false; }
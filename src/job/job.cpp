@@ -0,0 +1,126 @@
+#include "job.h"
+
+std::size_t JobSystem::_requestedWorkers = 0;
+thread_local int JobSystem::_current = -1;
+
+JobSystem::JobSystem() {
+    auto count = _requestedWorkers;
+    if (!count) {
+        // main thread is kept for SDL and exclusive work
+        auto cores = std::thread::hardware_concurrency();
+        count = cores > 1 ? cores - 1 : 1;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+        _queues.push_back(std::make_unique<Queue>());
+
+    for (std::size_t i = 0; i < count; ++i)
+        _workers.emplace_back([this, i] { _work(i); });
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+
+    for (auto& worker : _workers) worker.join();
+}
+
+// static
+void JobSystem::Configure(std::size_t workers) { _requestedWorkers = workers; }
+
+void JobSystem::submit(Job job) { _push(std::move(job)); }
+
+void JobSystem::submit(Job job, Counter& counter) {
+    ++counter._pending;
+    _push([job = std::move(job), &counter] {
+        job();
+        --counter._pending;
+    });
+}
+
+void JobSystem::wait(Counter& counter) {
+    while (!counter.done())
+        if (!help()) std::this_thread::yield();
+}
+
+bool JobSystem::help() {
+    Job job;
+    auto index = _current >= 0 ? std::size_t(_current) : _queues.size();
+
+    if ((index < _queues.size() && _pop(index, job)) || _steal(index, job)) {
+        job();
+        return true;
+    }
+    return false;
+}
+
+std::size_t JobSystem::workerCount() const { return _workers.size(); }
+
+void JobSystem::_push(Job job) {
+    // workers feed their own deque, other threads spread their jobs
+    auto index = _current >= 0 ? std::size_t(_current)
+                               : _nextQueue++ % _queues.size();
+
+    // counted before it can be popped, so that _queued never underflows
+    ++_queued;
+    {
+        auto& queue = *_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wake.notify_one();
+}
+
+bool JobSystem::_pop(std::size_t index, Job& job) {
+    auto& queue = *_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    --_queued;
+
+    return true;
+}
+
+bool JobSystem::_steal(std::size_t thief, Job& job) {
+    auto count = _queues.size();
+    for (std::size_t i = 1; i <= count; ++i) {
+        auto& queue = *_queues[(thief + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        --_queued;
+
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::_work(std::size_t index) {
+    _current = int(index);
+
+    while (true) {
+        Job job;
+        if (_pop(index, job) || _steal(index, job)) {
+            job();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wake.wait(lock, [this] { return _stop || _queued > 0; });
+        if (_stop && !_queued) return;
+    }
+}
+
+// static
+std::shared_ptr<JobSystem> JobSystem::Get() { return createInstance(); }
@@ -0,0 +1,126 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Work-stealing job system shared by engine subsystems
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../manager/manager.h"
+
+/**
+ * Job system
+ *
+ * Each worker owns a deque : it pushes and pops its own jobs at the back
+ * while idle workers steal from the front of the others. Jobs submitted
+ * from outside of the workers are spread between deques.
+ *
+ * Fork/join :
+ *
+ * JobSystem::Counter counter;
+ * jobs->submit([] { ... }, counter);
+ * jobs->submit([] { ... }, counter);
+ * jobs->wait(counter);  // runs pending jobs until both are done
+ */
+class JobSystem : Manager<JobSystem> {
+   public:
+    using Job = std::function<void()>;
+
+    // Number of unfinished jobs submitted with it
+    class Counter {
+        std::atomic<std::size_t> _pending{0};
+        friend class JobSystem;
+
+       public:
+        bool done() const { return _pending == 0; }
+    };
+
+    // queue a job, executed by the first available worker
+    void submit(Job);
+
+    // queue a job and track its completion with the counter
+    void submit(Job, Counter&);
+
+    // execute pending jobs from the calling thread until counter is done
+    void wait(Counter&);
+
+    // execute one pending job from the calling thread, if any
+    bool help();
+
+    /**
+     * Split [begin, end) in ranges of at most grain elements and call
+     * process(first, last) on each of them in parallel.
+     * Return once every range has been processed.
+     */
+    template <typename F>
+    void parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+                      F&& process) {
+        if (begin >= end) return;
+        if (!grain) grain = 1;
+
+        Counter counter;
+        auto first = begin;
+
+        // keep the first range for the calling thread
+        for (auto next = first + grain; next < end; next += grain) {
+            auto last = std::min(next + grain, end);
+            submit([&process, next, last] { process(next, last); }, counter);
+        }
+        process(first, std::min(first + grain, end));
+
+        wait(counter);
+    }
+
+    // number of worker threads
+    std::size_t workerCount() const;
+
+    // Set number of workers, must be called before first use.
+    // 0 : one worker per hardware thread, main thread excluded
+    static void Configure(std::size_t workers);
+
+    static std::shared_ptr<JobSystem> Get();
+
+   private:
+    JobSystem();
+    ~JobSystem();
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void _work(std::size_t index);
+    void _push(Job);
+    bool _pop(std::size_t index, Job&);
+    bool _steal(std::size_t thief, Job&);
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _workers;
+
+    // total of queued jobs, workers sleep while it is 0
+    // incremented before a job is pushed, decremented once it is taken
+    std::atomic<std::size_t> _queued{0};
+    std::atomic<std::size_t> _nextQueue{0};
+
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+    std::atomic<bool> _stop{false};
+
+    static std::size_t _requestedWorkers;
+
+    // index of the worker running on this thread, -1 outside of workers
+    static thread_local int _current;
+
+    friend class Manager<JobSystem>;
+};
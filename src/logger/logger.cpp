@@ -4,8 +4,12 @@
 
 std::shared_ptr<Logger> Logger::instance;
 
+thread_local Logger::Stream Logger::stream;
+thread_local Logger::Status Logger::curr_line_status = Logger::Status::INFO;
+
 Logger& Logger::Get() {
-    if (!instance) instance = std::make_shared<Logger>();
+    static std::once_flag created;
+    std::call_once(created, [] { instance = std::make_shared<Logger>(); });
     return *instance;
 }
 
@@ -16,7 +20,8 @@ bool Logger::dump(const Path& path) {
     std::ofstream file(path);
     if (!file) return false;
 
-    file << self.track.str() << self.stream.str();
+    std::lock_guard<std::mutex> lock(self.mutex);
+    file << self.track.str() << stream.str();
 
     return true;
 }
@@ -24,24 +29,27 @@ bool Logger::dump(const Path& path) {
 // static
 void Logger::endline() {
     auto& self = Get();
-    self.stream << std::endl;
-
-    switch (self.curr_line_status) {
-        case Status::INFO:
-        case Status::WARN:
-            std::cout << self.stream.str();
-            break;
-        case Status::ERROR:
-            std::cerr << self.stream.str();
-            break;
-        default:;
-    }
+    stream << std::endl;
+
+    {
+        std::lock_guard<std::mutex> lock(self.mutex);
+        switch (curr_line_status) {
+            case Status::INFO:
+            case Status::WARN:
+                std::cout << stream.str();
+                break;
+            case Status::ERROR:
+                std::cerr << stream.str();
+                break;
+            default:;
+        }
 
-    self.track << self.stream.str();
+        self.track << stream.str();
+    }
 
     // clear stream
-    self.stream.str("");
-    self.stream.clear();
+    stream.str("");
+    stream.clear();
 }
 
 // static
@@ -52,7 +60,10 @@ bool Logger::dumpStatus(Status status, const Path& path) {
     if (!file) return false;
 
     std::stringstream ss;
-    ss << self.track.str() << self.stream.str();
+    {
+        std::lock_guard<std::mutex> lock(self.mutex);
+        ss << self.track.str() << stream.str();
+    }
 
     std::string line;
     while (std::getline(ss, line)) {
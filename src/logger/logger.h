@@ -9,11 +9,13 @@
 #include <termcolor.h>
 
 #include <memory>
+#include <mutex>
 #include <sstream>
 
 #include "../path/path.h"
 
 // Interfaces are designed through static methods
+// Each thread builds its own line, endline writes it under a lock
 class Logger {
    public:
     enum class Status { INFO, WARN, ERROR };
@@ -25,8 +27,11 @@ class Logger {
     static Logger& Get();
 
     Stream track;
-    Stream stream;
-    Status curr_line_status;
+    std::mutex mutex;
+
+    // line being built by this thread
+    static thread_local Stream stream;
+    static thread_local Status curr_line_status;
 
    public:
     ~Logger() = default;
@@ -42,26 +47,25 @@ class Logger {
 
     template <typename... TArgs>
     static Stream& log(Logger::Status status, TArgs... contexts) {
-        auto& self = Get();
-        self.curr_line_status = status;
+        curr_line_status = status;
 
         switch (status) {
             case Status::INFO:
-                self.stream << termcolor::green << "[INFO] ";
+                stream << termcolor::green << "[INFO] ";
                 break;
             case Status::WARN:
-                self.stream << termcolor::yellow << "[WARN] ";
+                stream << termcolor::yellow << "[WARN] ";
                 break;
             case Status::ERROR:
-                self.stream << termcolor::red << "[ERROR]";
+                stream << termcolor::red << "[ERROR]";
                 break;
             default:;
         }
 
-        ((self.stream << '[' << contexts << ']'), ...);
-        self.stream << ' ' << termcolor::reset;
+        ((stream << '[' << contexts << ']'), ...);
+        stream << ' ' << termcolor::reset;
 
-        return self.stream;
+        return stream;
     }
 
     // helper for info message
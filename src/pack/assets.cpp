@@ -0,0 +1,112 @@
+#include "assets.h"
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "../logger/logger.h"
+#include "../renderer/renderer.h"
+#include "../serializer/binary.h"
+#include "../texture/atlas.h"
+
+bool AssetPack::open(const Path& path) {
+    std::string file(path);
+
+    if (!_reader.open(file)) {
+        Logger::error("AssetPack") << "Failed to open '" << file << "'";
+        Logger::endline();
+
+        return false;
+    }
+    _root = fs::path(file).parent_path().lexically_normal();
+
+    // pages are uploaded now, regions are resolved by the texture atlas
+    std::vector<SDL_Texture*> pages;
+    for (auto& [_, blob] : _reader.entries(Pack::Type::ATLAS_PAGE))
+        pages.push_back(_texture(blob));
+
+    std::map<std::uint32_t, std::vector<std::pair<std::string, SDL_Rect>>>
+        regions;
+    for (auto& [name, blob] : _reader.entries(Pack::Type::REGION)) {
+        Pack::Region region;
+        if (blob.size != sizeof(region)) continue;
+        std::memcpy(&region, blob.data, sizeof(region));
+
+        if (region.page < pages.size() && pages[region.page])
+            regions[region.page].emplace_back(
+                (_root / fs::path(name)).string(),
+                SDL_Rect{region.x, region.y, region.w, region.h});
+    }
+
+    auto atlas = TextureAtlas::Get();
+    for (auto& [page, content] : regions) atlas->addPage(pages[page], content);
+
+    Logger::info("AssetPack") << file << " : pack opened";
+    Logger::endline();
+
+    return true;
+}
+
+bool AssetPack::isOpen() const { return _reader.isOpen(); }
+
+std::string AssetPack::_name(const std::string& file) const {
+    auto name = fs::path(file).lexically_normal().lexically_relative(_root);
+    if (name.empty() || *name.begin() == "..") return "";
+    return name.generic_string();
+}
+
+bool AssetPack::_find(const std::string& file, Pack::Type type,
+                      PackReader::Blob& blob) const {
+    if (!_reader.isOpen()) return false;
+
+    auto name = _name(file);
+    return !name.empty() && _reader.find(name, blob) && blob.type == type;
+}
+
+SDL_Texture* AssetPack::_texture(const PackReader::Blob& blob) const {
+    Pack::Image image;
+    if (blob.size < sizeof(image)) return nullptr;
+    std::memcpy(&image, blob.data, sizeof(image));
+
+    if (blob.size - sizeof(image) < std::size_t(image.width) * image.height * 4)
+        return nullptr;
+
+    auto texture = SDL_CreateTexture(
+        RenderManager::Get()->renderer, SDL_PIXELFORMAT_RGBA32,
+        SDL_TEXTUREACCESS_STATIC, image.width, image.height);
+    if (!texture) return nullptr;
+
+    SDL_UpdateTexture(texture, NULL, blob.data + sizeof(image),
+                      image.width * 4);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    return texture;
+}
+
+bool AssetPack::image(const std::string& file, SDL_Texture*& texture) {
+    PackReader::Blob blob;
+    if (!_find(file, Pack::Type::IMAGE, blob)) return false;
+
+    texture = _texture(blob);
+    return texture != nullptr;
+}
+
+bool AssetPack::document(const std::string& file, YAML::Node& node) {
+    PackReader::Blob blob;
+    if (!_find(file, Pack::Type::DOCUMENT, blob)) return false;
+
+    if (!BinaryYAML::decode(blob.data, blob.size, node)) {
+        Logger::error("AssetPack") << file << " : corrupted document";
+        Logger::endline();
+
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::tilemap(const std::string& file, PackReader::Blob& blob) {
+    return _find(file, Pack::Type::TILEMAP, blob);
+}
+
+// static
+std::shared_ptr<AssetPack> AssetPack::Get() { return createInstance(); }
@@ -0,0 +1,58 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Runtime access to a cooked asset pack
+ */
+
+#pragma once
+
+#include <SDL.h>
+#include <yaml-cpp/yaml.h>
+
+#include <memory>
+#include <string>
+
+#include "../manager/manager.h"
+#include "../path/path.h"
+#include "pack.h"
+
+/**
+ * Once a pack is opened, loaders look their file up here before
+ * touching the disk : Texture::load gets pre-decoded pixels or an atlas
+ * region, Serializer::deserialize a binary scene and Tilemap the map data.
+ *
+ * Files are matched relatively to the directory holding the pack,
+ * which should be the cooked directory.
+ */
+class AssetPack : Manager<AssetPack> {
+   public:
+    static std::shared_ptr<AssetPack> Get();
+
+    // map the pack and register its atlas pages
+    bool open(const Path&);
+
+    bool isOpen() const;
+
+    // create a texture from a pre-decoded image
+    bool image(const std::string& file, SDL_Texture*&);
+
+    // rebuild a cooked YAML document
+    bool document(const std::string& file, YAML::Node&);
+
+    bool tilemap(const std::string& file, PackReader::Blob&);
+
+   private:
+    PackReader _reader;
+    fs::path _root;
+
+    AssetPack() = default;
+
+    // entry name of a file, empty if outside of the pack directory
+    std::string _name(const std::string& file) const;
+
+    bool _find(const std::string& file, Pack::Type, PackReader::Blob&) const;
+
+    SDL_Texture* _texture(const PackReader::Blob&) const;
+
+    friend class Manager<AssetPack>;
+};
@@ -0,0 +1,200 @@
+#include "pack.h"
+
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ECS_PACK_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::size_t aligned(std::size_t offset) {
+    return (offset + Pack::ALIGNMENT - 1) / Pack::ALIGNMENT * Pack::ALIGNMENT;
+}
+
+}  // namespace
+
+void PackWriter::add(Pack::Type type, const std::string& name,
+                     const void* data, std::size_t size) {
+    auto bytes = static_cast<const char*>(data);
+    _items.push_back({type, name, std::vector<char>(bytes, bytes + size)});
+}
+
+void PackWriter::addImage(Pack::Type type, const std::string& name,
+                          std::uint32_t width, std::uint32_t height,
+                          const void* pixels) {
+    Pack::Image header = {width, height};
+    std::size_t size = std::size_t(width) * height * 4;
+
+    Item item = {type, name, std::vector<char>(sizeof(header) + size)};
+    std::memcpy(item.data.data(), &header, sizeof(header));
+    std::memcpy(item.data.data() + sizeof(header), pixels, size);
+    _items.push_back(std::move(item));
+}
+
+std::size_t PackWriter::size() const { return _items.size(); }
+
+bool PackWriter::write(const std::string& file) const {
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    std::vector<Pack::Entry> toc;
+    std::string names;
+
+    // header is written last, once the table of contents is known
+    Pack::Header header = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // payloads
+    std::size_t offset = sizeof(Pack::Header);
+    for (auto& item : _items) {
+        auto start = aligned(offset);
+        out.write(std::string(start - offset, '\0').data(), start - offset);
+        out.write(item.data.data(), item.data.size());
+        offset = start + item.data.size();
+
+        toc.push_back({start, item.data.size(), item.type,
+                       std::uint32_t(names.size()),
+                       std::uint32_t(item.name.size()), 0});
+        names += item.name;
+    }
+
+    auto tocOffset = aligned(offset);
+    out.write(std::string(tocOffset - offset, '\0').data(),
+              tocOffset - offset);
+    out.write(reinterpret_cast<const char*>(toc.data()),
+              toc.size() * sizeof(Pack::Entry));
+    out.write(names.data(), names.size());
+
+    std::memcpy(header.magic, Pack::MAGIC, sizeof(header.magic));
+    header.version = Pack::VERSION;
+    header.count = std::uint32_t(toc.size());
+    header.toc = tocOffset;
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    return bool(out);
+}
+
+PackReader::~PackReader() { close(); }
+
+bool PackReader::open(const std::string& file) {
+    close();
+
+    if (!_map(file) && !_read(file)) return false;
+    if (_parse()) return true;
+
+    close();
+    return false;
+}
+
+bool PackReader::_map(const std::string& file) {
+#ifdef ECS_PACK_MMAP
+    auto fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    auto data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return false;
+
+    _data = static_cast<const char*>(data);
+    _size = info.st_size;
+    _mapped = true;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PackReader::_read(const std::string& file) {
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+
+    _buffer.resize(std::size_t(in.tellg()));
+    in.seekg(0);
+    if (!in.read(_buffer.data(), _buffer.size())) return false;
+
+    _data = _buffer.data();
+    _size = _buffer.size();
+
+    return true;
+}
+
+bool PackReader::_parse() {
+    if (_size < sizeof(Pack::Header)) return false;
+
+    Pack::Header header;
+    std::memcpy(&header, _data, sizeof(header));
+    if (std::memcmp(header.magic, Pack::MAGIC, sizeof(header.magic)) ||
+        header.version != Pack::VERSION)
+        return false;
+
+    auto tocSize = std::size_t(header.count) * sizeof(Pack::Entry);
+    if (header.toc > _size || tocSize > _size - header.toc) return false;
+
+    auto names = _data + header.toc + tocSize;
+    auto namesSize = _size - header.toc - tocSize;
+
+    for (std::uint32_t i = 0; i < header.count; ++i) {
+        Pack::Entry entry;
+        std::memcpy(&entry, _data + header.toc + i * sizeof(entry),
+                    sizeof(entry));
+
+        if (entry.offset > _size || entry.size > _size - entry.offset ||
+            std::size_t(entry.nameOffset) + entry.nameLength > namesSize)
+            return false;
+
+        std::string_view name(names + entry.nameOffset, entry.nameLength);
+        _index[name] = _toc.size();
+        _toc.push_back({name,
+                        {entry.type, _data + entry.offset,
+                         std::size_t(entry.size)}});
+    }
+
+    return true;
+}
+
+void PackReader::close() {
+#ifdef ECS_PACK_MMAP
+    if (_mapped) munmap(const_cast<char*>(_data), _size);
+#endif
+    _mapped = false;
+    _data = nullptr;
+    _size = 0;
+
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+    _toc.clear();
+    _index.clear();
+}
+
+bool PackReader::isOpen() const { return _data != nullptr; }
+
+bool PackReader::find(std::string_view name, Blob& blob) const {
+    auto it = _index.find(name);
+    if (it == _index.end()) return false;
+
+    blob = _toc[it->second].second;
+    return true;
+}
+
+std::vector<std::pair<std::string_view, PackReader::Blob>> PackReader::entries(
+    Pack::Type type) const {
+    std::vector<std::pair<std::string_view, Blob>> ret;
+    for (auto& entry : _toc)
+        if (entry.second.type == type) ret.push_back(entry);
+    return ret;
+}
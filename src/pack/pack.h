@@ -0,0 +1,140 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Binary asset pack produced by ecs-cook
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Layout :
+ *  Header | payloads (16 bytes aligned) | table of contents | names
+ *
+ * Entry names are generic paths relative to the cooked directory.
+ * Integers are stored in host byte order.
+ */
+namespace Pack {
+
+enum class Type : std::uint32_t {
+    // Image header followed by RGBA32 pixels
+    IMAGE,
+    // IMAGE payload holding packed images
+    ATLAS_PAGE,
+    // Region of an image inside an ATLAS_PAGE
+    REGION,
+    // YAML document (scene, template) in binary form
+    DOCUMENT,
+    // Tiled map
+    TILEMAP
+};
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint64_t toc;
+};
+
+struct Entry {
+    std::uint64_t offset;
+    std::uint64_t size;
+    Type type;
+    // inside the names block following the table of contents
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::uint32_t reserved;
+};
+
+struct Image {
+    std::uint32_t width;
+    std::uint32_t height;
+};
+
+struct Region {
+    // index of the page among ATLAS_PAGE entries, in pack order
+    std::uint32_t page;
+    std::int32_t x, y, w, h;
+};
+
+constexpr char MAGIC[8] = "ECSPACK";
+constexpr std::uint32_t VERSION = 1;
+constexpr std::size_t ALIGNMENT = 16;
+
+}  // namespace Pack
+
+// Build a pack in memory and write it at once
+class PackWriter {
+   public:
+    void add(Pack::Type, const std::string& name, const void* data,
+             std::size_t size);
+
+    // image header and pixels, pitch must be width * 4
+    void addImage(Pack::Type, const std::string& name, std::uint32_t width,
+                  std::uint32_t height, const void* pixels);
+
+    bool write(const std::string& file) const;
+
+    std::size_t size() const;
+
+   private:
+    struct Item {
+        Pack::Type type;
+        std::string name;
+        std::vector<char> data;
+    };
+
+    std::vector<Item> _items;
+};
+
+/**
+ * Read-only view of a pack file.
+ * The file is memory mapped when the platform allows it,
+ * read at once otherwise.
+ */
+class PackReader {
+   public:
+    struct Blob {
+        Pack::Type type;
+        const char* data;
+        std::size_t size;
+    };
+
+    PackReader() = default;
+    ~PackReader();
+
+    PackReader(const PackReader&) = delete;
+    PackReader& operator=(const PackReader&) = delete;
+
+    bool open(const std::string& file);
+
+    void close();
+
+    bool isOpen() const;
+
+    bool find(std::string_view name, Blob&) const;
+
+    // entries of the given type, in pack order
+    std::vector<std::pair<std::string_view, Blob>> entries(Pack::Type) const;
+
+   private:
+    const char* _data = nullptr;
+    std::size_t _size = 0;
+    bool _mapped = false;
+
+    // read fallback
+    std::vector<char> _buffer;
+
+    std::vector<std::pair<std::string_view, Blob>> _toc;
+    std::unordered_map<std::string_view, std::size_t> _index;
+
+    bool _map(const std::string& file);
+    bool _read(const std::string& file);
+    bool _parse();
+};
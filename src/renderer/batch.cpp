@@ -0,0 +1,81 @@
+#include "batch.h"
+
+#include <cmath>
+
+void SpriteBatch::add(SDL_Renderer* renderer, const Quad& quad) {
+    if (!quad.texture) return;
+
+    SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+    SDL_GetTextureBlendMode(quad.texture, &blendMode);
+
+    if (quad.texture != _texture || blendMode != _blendMode) {
+        flush(renderer);
+        _begin(quad.texture, blendMode);
+    }
+
+    auto& src = quad.source;
+    auto& dst = quad.destination;
+
+    float u0 = src.x * _texel.x, u1 = (src.x + src.w) * _texel.x;
+    float v0 = src.y * _texel.y, v1 = (src.y + src.h) * _texel.y;
+    if (quad.flip & SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+    if (quad.flip & SDL_FLIP_VERTICAL) std::swap(v0, v1);
+
+    // corners relative to the pivot
+    float px = float(dst.x + quad.center.x), py = float(dst.y + quad.center.y);
+    float left = dst.x - px, top = dst.y - py;
+    float right = left + dst.w, bottom = top + dst.h;
+
+    float c = 1.0f, s = 0.0f;
+    if (quad.angle != 0.0) {
+        auto radian = quad.angle * M_PI / 180.0;
+        c = float(std::cos(radian));
+        s = float(std::sin(radian));
+    }
+
+    // clockwise from top-left, same winding as SDL_RenderCopyEx
+    const float corners[4][4] = {{left, top, u0, v0},
+                                 {right, top, u1, v0},
+                                 {right, bottom, u1, v1},
+                                 {left, bottom, u0, v1}};
+
+    int base = int(_vertices.size());
+    for (auto& corner : corners) {
+        auto x = corner[0], y = corner[1];
+        _vertices.push_back({{px + x * c - y * s, py + x * s + y * c},
+                             _color,
+                             {corner[2], corner[3]}});
+    }
+
+    for (auto i : {0, 1, 2, 0, 2, 3}) _indices.push_back(base + i);
+}
+
+void SpriteBatch::flush(SDL_Renderer* renderer) {
+    if (_vertices.empty()) return;
+
+    SDL_RenderGeometry(renderer, _texture, _vertices.data(),
+                       int(_vertices.size()), _indices.data(),
+                       int(_indices.size()));
+    _drawCalls++;
+
+    _vertices.clear();
+    _indices.clear();
+    _texture = nullptr;
+}
+
+void SpriteBatch::_begin(SDL_Texture* texture, SDL_BlendMode blendMode) {
+    _texture = texture;
+    _blendMode = blendMode;
+
+    int w = 0, h = 0;
+    SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+    _texel = {w ? 1.0f / w : 0.0f, h ? 1.0f / h : 0.0f};
+
+    // SDL_RenderGeometry ignores texture modulation, use vertex color instead
+    SDL_GetTextureColorMod(texture, &_color.r, &_color.g, &_color.b);
+    SDL_GetTextureAlphaMod(texture, &_color.a);
+}
+
+std::size_t SpriteBatch::drawCalls() const { return _drawCalls; }
+
+void SpriteBatch::resetStatistics() { _drawCalls = 0; }
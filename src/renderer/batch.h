@@ -0,0 +1,55 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Sprite batching through SDL_RenderGeometry
+ */
+
+#pragma once
+
+#include <SDL.h>
+
+#include <vector>
+
+// Textured quad, same parameters as SDL_RenderCopyEx
+struct Quad {
+    SDL_Texture* texture;
+    SDL_Rect source;
+    SDL_Rect destination;
+    // rotation pivot, relative to destination
+    SDL_Point center;
+    double angle;
+    SDL_RendererFlip flip;
+};
+
+/**
+ * Accumulate consecutive quads sharing the same texture and blend mode
+ * and draw them with a single SDL_RenderGeometry call.
+ */
+class SpriteBatch {
+   public:
+    // append a quad, the pending batch is flushed first
+    // if texture or blend mode differ
+    void add(SDL_Renderer*, const Quad&);
+
+    // draw pending quads
+    void flush(SDL_Renderer*);
+
+    // number of SDL_RenderGeometry calls since last reset
+    std::size_t drawCalls() const;
+
+    void resetStatistics();
+
+   private:
+    SDL_Texture* _texture = nullptr;
+    SDL_BlendMode _blendMode = SDL_BLENDMODE_NONE;
+    SDL_Color _color = {255, 255, 255, 255};
+    // inverse of texture size, to compute texture coordinates
+    SDL_FPoint _texel = {0.0f, 0.0f};
+
+    std::vector<SDL_Vertex> _vertices;
+    std::vector<int> _indices;
+
+    std::size_t _drawCalls = 0;
+
+    void _begin(SDL_Texture*, SDL_BlendMode);
+};
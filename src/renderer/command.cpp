@@ -0,0 +1,25 @@
+#include "command.h"
+
+#include <algorithm>
+#include <cassert>
+
+std::uint64_t RenderCommand::Key(std::size_t layer, int depth,
+                                 std::uint32_t texture) {
+    assert(depth >= -0x8000 && depth <= 0x7fff && "Depth out of int16 range");
+
+    // bias depth so that negative values come first
+    depth = std::clamp(depth, -0x8000, 0x7fff);
+    auto d = std::uint16_t(depth + 0x8000);
+
+    return (std::uint64_t(std::uint16_t(layer)) << 48) |
+           (std::uint64_t(d) << 32) | texture;
+}
+
+std::uint32_t RenderCommand::texture() const {
+    return std::uint32_t(key & 0xffffffff);
+}
+
+bool RenderCommand::operator<(const RenderCommand& command) const {
+    if (key != command.key) return key < command.key;
+    return sequence < command.sequence;
+}
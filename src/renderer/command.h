@@ -0,0 +1,82 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Plain data render commands
+ */
+
+#pragma once
+
+#include <SDL.h>
+
+#include <cstdint>
+#include <functional>
+
+#include "batch.h"
+
+using RenderCallback = std::function<void(SDL_Renderer*)>;
+
+// How commands of a layer are ordered before playback
+// untextured commands (rects, lines, callbacks) sort before textured ones
+enum class SortMode {
+    // submission order
+    NONE,
+    // depth first, then texture
+    DEPTH_TEXTURE,
+    // texture only, for layers where overlapping order does not matter
+    TEXTURE
+};
+
+struct FilledRect {
+    SDL_Rect rect;
+    SDL_Color color;
+};
+
+struct Line {
+    SDL_Point from, to;
+    SDL_Color color;
+};
+
+// vertices and indices are copied on submit
+struct Geometry {
+    SDL_Texture* texture;
+    const SDL_Vertex* vertices;
+    int verticesCount;
+    // may be null, vertices are then drawn in order
+    const int* indices;
+    int indicesCount;
+};
+
+/**
+ * Commands live in the render manager's per-frame arena
+ * and are only valid until the end of RenderManager::draw.
+ */
+struct RenderCommand {
+    enum Type : std::uint8_t { SPRITE, FILL_RECT, LINE, GEOMETRY, CUSTOM };
+
+    // layer (16 bits) | depth (16 bits) | texture ID (32 bits)
+    std::uint64_t key;
+
+    // submission order inside the layer, ties are resolved with it
+    std::uint32_t sequence;
+
+    Type type;
+
+    union {
+        Quad sprite;
+        FilledRect rect;
+        Line line;
+        Geometry geometry;
+        // escape hatch, owned by the arena
+        const RenderCallback* callback;
+    };
+
+    // depth must fit in 16 bits : [-32768, 32767]
+    // texture IDs are given by the render manager, 0 : untextured
+    static std::uint64_t Key(std::size_t layer, int depth,
+                             std::uint32_t texture);
+
+    // texture ID part of the key
+    std::uint32_t texture() const;
+
+    bool operator<(const RenderCommand&) const;
+};
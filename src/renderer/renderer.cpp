@@ -1,14 +1,155 @@
 #include "renderer.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "../application/application.h"
+#include "../job/job.h"
 
 RenderManager::RenderManager() {}
 RenderManager::~RenderManager() { SDL_DestroyRenderer(renderer); }
 
+RenderCommand* RenderManager::_command(RenderCommand::Type type,
+                                       std::size_t layer_n, int depth,
+                                       SDL_Texture* texture) {
+    auto command = _frame.create<RenderCommand>();
+    command->type = type;
+    command->key = RenderCommand::Key(layer_n, depth, _textureID(texture));
+    layers[layer_n].add(command);
+    return command;
+}
+
+std::uint32_t RenderManager::_textureID(SDL_Texture* texture) {
+    if (!texture) return 0;
+
+    auto id = std::uint32_t(_textureIDs.size() + 1);
+    return _textureIDs.emplace(texture, id).first->second;
+}
+
 void RenderManager::submit(const Process& drawer, std::size_t layer_n) {
-    layers[layer_n].add(drawer);
+    _command(RenderCommand::CUSTOM, layer_n, 0)->callback =
+        _frame.create<Process>(drawer);
+}
+
+void RenderManager::submit(const Quad& quad, std::size_t layer_n, int depth) {
+    _command(RenderCommand::SPRITE, layer_n, depth, quad.texture)->sprite =
+        quad;
+}
+
+void RenderManager::submit(const FilledRect& rect, std::size_t layer_n,
+                           int depth) {
+    _command(RenderCommand::FILL_RECT, layer_n, depth)->rect = rect;
+}
+
+void RenderManager::submit(const Line& line, std::size_t layer_n, int depth) {
+    _command(RenderCommand::LINE, layer_n, depth)->line = line;
+}
+
+void RenderManager::submit(const Geometry& geometry, std::size_t layer_n,
+                           int depth) {
+    auto copy = geometry;
+
+    auto vertices = static_cast<SDL_Vertex*>(_frame.allocate(
+        sizeof(SDL_Vertex) * geometry.verticesCount, alignof(SDL_Vertex)));
+    std::copy_n(geometry.vertices, geometry.verticesCount, vertices);
+    copy.vertices = vertices;
+
+    if (geometry.indices) {
+        auto indices = static_cast<int*>(_frame.allocate(
+            sizeof(int) * geometry.indicesCount, alignof(int)));
+        std::copy_n(geometry.indices, geometry.indicesCount, indices);
+        copy.indices = indices;
+    }
+
+    _command(RenderCommand::GEOMETRY, layer_n, depth, geometry.texture)
+        ->geometry = copy;
+}
+
+void RenderManager::setSortMode(std::size_t layer_n, SortMode mode) {
+    layers[layer_n].sortMode = mode;
+}
+
+std::size_t RenderManager::textureSwitches() const { return _textureSwitches; }
+
+std::size_t RenderManager::batchDrawCalls() const { return _batchDrawCalls; }
+
+void RenderManager::Drawer::sort() {
+    auto less = [](RenderCommand* a, RenderCommand* b) { return *a < *b; };
+    auto byTexture = [](RenderCommand* a, RenderCommand* b) {
+        if (a->texture() != b->texture()) return a->texture() < b->texture();
+        return a->sequence < b->sequence;
+    };
+
+    switch (sortMode) {
+        case SortMode::DEPTH_TEXTURE:
+            std::sort(commands.begin(), commands.end(), less);
+            break;
+        case SortMode::TEXTURE:
+            std::sort(commands.begin(), commands.end(), byTexture);
+            break;
+        default:
+            break;
+    }
+}
+
+void RenderManager::Drawer::operator()() {
+    SDL_Texture* bound = nullptr;
+    textureSwitches = 0;
+    batch.resetStatistics();
+
+    for (auto command : commands) {
+        auto texture = command->type == RenderCommand::SPRITE
+                           ? command->sprite.texture
+                       : command->type == RenderCommand::GEOMETRY
+                           ? command->geometry.texture
+                           : nullptr;
+        if (texture && texture != bound) {
+            bound = texture;
+            textureSwitches++;
+        }
+
+        if (command->type == RenderCommand::SPRITE) {
+            batch.add(renderer, command->sprite);
+            continue;
+        }
+
+        // keep painter order : pending sprites go first
+        batch.flush(renderer);
+
+        switch (command->type) {
+            case RenderCommand::FILL_RECT: {
+                auto& [rect, color] = command->rect;
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b,
+                                       color.a);
+                SDL_RenderFillRect(renderer, &rect);
+                break;
+            }
+
+            case RenderCommand::LINE: {
+                auto& [from, to, color] = command->line;
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b,
+                                       color.a);
+                SDL_RenderDrawLine(renderer, from.x, from.y, to.x, to.y);
+                break;
+            }
+
+            case RenderCommand::GEOMETRY: {
+                auto& g = command->geometry;
+                SDL_RenderGeometry(renderer, g.texture, g.vertices,
+                                   g.verticesCount, g.indices, g.indicesCount);
+                break;
+            }
+
+            case RenderCommand::CUSTOM:
+                (*command->callback)(renderer);
+                break;
+
+            default:
+                break;
+        }
+    }
+    batch.flush(renderer);
+    clear();
 }
 
 void RenderManager::clear(const SDL_Rect& rect, const SDL_Color& color) {
@@ -22,9 +163,27 @@ void RenderManager::clear(const SDL_Color& color) {
 }
 
 void RenderManager::draw() {
+    _textureSwitches = _batchDrawCalls = 0;
+
+    // large layers are sorted on the workers, playback stays on this thread
+    auto jobs = JobSystem::Get();
+    JobSystem::Counter sorted;
+    for (auto& [_, layer] : layers) {
+        if (layer.sortMode == SortMode::NONE || layer.commands.size() < 2)
+            continue;
+
+        if (layer.commands.size() < PARALLEL_SORT)
+            layer.sort();
+        else
+            jobs->submit([&layer = layer] { layer.sort(); }, sorted);
+    }
+    jobs->wait(sorted);
+
     for (auto& [_, layer] : layers) {
         layer.prepare();
         layer();
+        _textureSwitches += layer.textureSwitches;
+        _batchDrawCalls += layer.batch.drawCalls();
     }
     SDL_SetRenderTarget(renderer, NULL);
     for (auto c : Camera::instances) {
@@ -64,9 +223,14 @@ void RenderManager::draw() {
                                       rotation, NULL, SDL_FLIP_NONE);
                 }
             }
-            if (c->clear & c->TEXTURE)
-                SDL_RenderCopyExF(renderer, c->backgroundImage.get(), &rect,
+            if (c->clear & c->TEXTURE) {
+                // background may be a region of an atlas page
+                auto region = c->backgroundImage.getRegion();
+                SDL_Rect src = {rect.x + region.x, rect.y + region.y, rect.w,
+                                rect.h};
+                SDL_RenderCopyExF(renderer, c->backgroundImage.get(), &src,
                                   &dest, rotation, NULL, flip);
+            }
 
             SDL_RenderCopyExF(renderer, layers[index].target, &rect, &dest,
                               rotation, NULL, flip);
@@ -75,6 +239,10 @@ void RenderManager::draw() {
 
     // camera draws
     SDL_RenderPresent(renderer);
+
+    // commands have been played back
+    _frame.reset();
+    _textureIDs.clear();
 }
 
 VectorI RenderManager::globalCoordinates(float x, float y) const {
@@ -12,10 +12,13 @@
 #include <functional>
 #include <map>
 #include <memory>
-#include <queue>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "../manager/manager.h"
+#include "../util/memory/arena.h"
+#include "command.h"
 #include "../ecs/components.h"
 
 class Application;
@@ -24,11 +27,17 @@ class Application;
 class RenderManager: Manager<RenderManager> {
    public:
     using Camera = Component::camera;
-    using Process = std::function<void(SDL_Renderer*)>;
-    
+    using Process = RenderCallback;
+
     struct Drawer {
         std::shared_ptr<RenderManager> renderManager = RenderManager::Get();
-        std::queue<Process> process;
+        // allocated in the render manager's frame arena
+        std::vector<RenderCommand*> commands;
+        SortMode sortMode = SortMode::NONE;
+        SpriteBatch batch;
+
+        // texture changes during last playback
+        std::size_t textureSwitches = 0;
         SDL_Texture* target = nullptr;
 
         SDL_Renderer* renderer = renderManager->renderer;
@@ -47,13 +56,13 @@ class RenderManager: Manager<RenderManager> {
             SDL_DestroyTexture(target);
         }
 
-        void add(const Process& p) { process.push(p); }
-
-        void clear() {
-            std::queue<Process> empty;
-            std::swap(empty, process);
+        void add(RenderCommand* command) {
+            command->sequence = std::uint32_t(commands.size());
+            commands.push_back(command);
         }
 
+        void clear() { commands.clear(); }
+
         void prepare() {
             SDL_SetRenderTarget(renderer, target);
             SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
@@ -61,12 +70,11 @@ class RenderManager: Manager<RenderManager> {
             SDL_SetRenderTarget(renderer, target);
         }
 
-        void operator()() {
-            while (!process.empty()) {
-                process.front()(renderer);
-                process.pop();
-            }
-        }
+        // order commands according to the sort mode
+        void sort();
+
+        // play commands back, in the order left by sort
+        void operator()();
     };
 
     static std::shared_ptr<RenderManager> Get();
@@ -84,6 +92,25 @@ class RenderManager: Manager<RenderManager> {
     // default : first layer (index 0)
     void submit(const Process&, std::size_t index = 0);
 
+    // batched sprite drawing, consecutive quads using the same texture
+    // are drawn with a single call
+    void submit(const Quad&, std::size_t index = 0, int depth = 0);
+
+    void submit(const FilledRect&, std::size_t index = 0, int depth = 0);
+
+    void submit(const Line&, std::size_t index = 0, int depth = 0);
+
+    void submit(const Geometry&, std::size_t index = 0, int depth = 0);
+
+    // opt-in reordering of a layer to reduce texture switches
+    void setSortMode(std::size_t index, SortMode);
+
+    // texture switches during the last frame, over every layer
+    std::size_t textureSwitches() const;
+
+    // SDL_RenderGeometry calls issued by sprite batches during the last frame
+    std::size_t batchDrawCalls() const;
+
     VectorI getSize() const;
 
     VectorI globalCoordinates(float, float) const;
@@ -102,6 +129,23 @@ class RenderManager: Manager<RenderManager> {
     // There is always one layer remaining
     std::map<int, Drawer> layers;
 
+    // render commands of the current frame
+    Arena _frame;
+
+    // smaller layers are sorted inline, a job would cost more than the sort
+    static constexpr std::size_t PARALLEL_SORT = 512;
+
+    std::size_t _textureSwitches = 0;
+    std::size_t _batchDrawCalls = 0;
+
+    // sort key IDs of the textures used this frame, from 1 in first use order
+    std::unordered_map<SDL_Texture*, std::uint32_t> _textureIDs;
+
+    std::uint32_t _textureID(SDL_Texture*);
+
+    RenderCommand* _command(RenderCommand::Type, std::size_t layer, int depth,
+                            SDL_Texture* texture = nullptr);
+
     RenderManager();
     ~RenderManager();
 
@@ -31,6 +31,12 @@ class Scene {
 
     Group& getEntities();
 
+    // typed view over entities of this scene having all of Ts
+    template <typename... Ts>
+    View<Ts...> view() const {
+        return _entities.view<Ts...>();
+    }
+
    protected:
     Scene(const std::string&);
     virtual ~Scene() = default;
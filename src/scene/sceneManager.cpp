@@ -10,7 +10,8 @@ using Couple = std::pair<Scene*, Scene*>;
 
 void SceneManager::load(const std::string& fileName) {
     auto scene = Application::Get().getSerializer().deserialize(fileName);
-    EventManager::Get()->emit(Input.SCENE_LOADED).attach<Scene*>(scene);
+    EventManager::Get()->_emit(Input.SCENE_LOADED).attach<Scene*>(scene);
+    EventBus::Get()->emit<Events::SceneLoaded>(scene);
 }
 
 Scene& SceneManager::getActive() { return *scenes[0]; }
@@ -29,7 +30,8 @@ void SceneManager::setActive(const std::string& tag) {
     auto scene = *it;
     // puts the element at the end of the queue
     scenes.push_front(scene);
-    EventManager::Get()->emit(Input.SCENE_CHANGED);
+    EventManager::Get()->_emit(Input.SCENE_CHANGED);
+    EventBus::Get()->emit<Events::SceneChanged>();
 }
 
 void SceneManager::setActive(std::size_t index) {
@@ -40,7 +42,8 @@ void SceneManager::setActive(std::size_t index) {
     scenes.erase(scenes.begin() + index);
 
     scenes.push_front(scene);
-    EventManager::Get()->emit(Input.SCENE_CHANGED);
+    EventManager::Get()->_emit(Input.SCENE_CHANGED);
+    EventBus::Get()->emit<Events::SceneChanged>();
 }
 
 void SceneManager::remove(const std::string& tag) {
@@ -80,7 +83,8 @@ void SceneManager::next() {
     auto scene = scenes[0];
     delete scene;
     scenes.pop_front();
-    EventManager::Get()->emit(Input.SCENE_CHANGED);
+    EventManager::Get()->_emit(Input.SCENE_CHANGED);
+    EventBus::Get()->emit<Events::SceneChanged>();
 }
 
 SceneManager::~SceneManager() {
@@ -0,0 +1,116 @@
+#include "binary.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace BinaryYAML {
+
+namespace {
+
+enum Kind : std::uint8_t { NIL, SCALAR, SEQUENCE, MAP };
+
+void writeSize(std::string& out, std::size_t size) {
+    auto value = std::uint32_t(size);
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write(std::string& out, const YAML::Node& node) {
+    switch (node.Type()) {
+        case YAML::NodeType::Scalar: {
+            auto& scalar = node.Scalar();
+            out.push_back(SCALAR);
+            writeSize(out, scalar.size());
+            out += scalar;
+            break;
+        }
+
+        case YAML::NodeType::Sequence:
+            out.push_back(SEQUENCE);
+            writeSize(out, node.size());
+            for (auto item : node) write(out, item);
+            break;
+
+        case YAML::NodeType::Map:
+            out.push_back(MAP);
+            writeSize(out, node.size());
+            for (auto pair : node) {
+                write(out, pair.first);
+                write(out, pair.second);
+            }
+            break;
+
+        default:
+            out.push_back(NIL);
+            break;
+    }
+}
+
+struct Reader {
+    const char* data;
+    const char* end;
+
+    bool size(std::uint32_t& value) {
+        if (end - data < std::ptrdiff_t(sizeof(value))) return false;
+        std::memcpy(&value, data, sizeof(value));
+        data += sizeof(value);
+        return true;
+    }
+
+    bool node(YAML::Node& out) {
+        if (data == end) return false;
+
+        auto kind = Kind(*data++);
+        std::uint32_t count;
+
+        switch (kind) {
+            case NIL:
+                out = YAML::Node(YAML::NodeType::Null);
+                return true;
+
+            case SCALAR:
+                if (!size(count) || end - data < std::ptrdiff_t(count))
+                    return false;
+                out = YAML::Node(std::string(data, count));
+                data += count;
+                return true;
+
+            case SEQUENCE:
+                if (!size(count)) return false;
+                out = YAML::Node(YAML::NodeType::Sequence);
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    YAML::Node item;
+                    if (!node(item)) return false;
+                    out.push_back(item);
+                }
+                return true;
+
+            case MAP:
+                if (!size(count)) return false;
+                out = YAML::Node(YAML::NodeType::Map);
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    YAML::Node key, value;
+                    if (!node(key) || !node(value)) return false;
+                    out.force_insert(key, value);
+                }
+                return true;
+
+            default:
+                return false;
+        }
+    }
+};
+
+}  // namespace
+
+std::string encode(const YAML::Node& node) {
+    std::string ret;
+    write(ret, node);
+    return ret;
+}
+
+bool decode(const char* data, std::size_t size, YAML::Node& node) {
+    Reader reader = {data, data + size};
+    return reader.node(node) && reader.data == reader.end;
+}
+
+}  // namespace BinaryYAML
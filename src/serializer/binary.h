@@ -0,0 +1,31 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Compact binary form of YAML documents
+ */
+
+#pragma once
+
+#include <yaml-cpp/yaml.h>
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Node tree written depth first :
+ *  null : kind
+ *  scalar : kind | length | bytes
+ *  sequence : kind | count | items
+ *  map : kind | count | key, value pairs
+ *
+ * Rebuilding a node does not go through the YAML parser.
+ * Tags and styles are not kept.
+ */
+namespace BinaryYAML {
+
+std::string encode(const YAML::Node&);
+
+// false on malformed input
+bool decode(const char* data, std::size_t size, YAML::Node&);
+
+}  // namespace BinaryYAML
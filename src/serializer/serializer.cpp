@@ -6,6 +6,7 @@
 
 #include "../ecs/components.h"
 #include "../logger/logger.h"
+#include "../pack/assets.h"
 
 template <typename VType>
 YAML::Emitter &operator<<(YAML::Emitter &out, const Vector<VType> &v) {
@@ -39,18 +40,23 @@ Scene *Serializer::deserialize(const std::string &source) {
         return nullptr;
     };
 
-    std::ifstream file(source);
-    if (!file) {
-        Logger::error("Deserializer")
-            << "Scene file : " << source << " doesn't exist!";
-        Logger::endline();
+    YAML::Node node;
 
-        return nullptr;
-    }
+    // cooked scenes skip YAML parsing
+    if (!AssetPack::Get()->document(source, node)) {
+        std::ifstream file(source);
+        if (!file) {
+            Logger::error("Deserializer")
+                << "Scene file : " << source << " doesn't exist!";
+            Logger::endline();
 
-    std::stringstream ss;
-    ss << file.rdbuf();
-    YAML::Node node = YAML::Load(ss.str());
+            return nullptr;
+        }
+
+        std::stringstream ss;
+        ss << file.rdbuf();
+        node = YAML::Load(ss.str());
+    }
 
     auto name = node["Name"];
     if (!name) return error("'Name' node was not found");
@@ -62,8 +68,9 @@ Scene *Serializer::deserialize(const std::string &source) {
 
     for (auto entity : entities)
         if (entity["ID"])
-            deserializeEntity(
-                entity, scene->_entities.create(entity["ID"].as<EntityID>()));
+            deserializeEntity(entity,
+                              scene->_entities.create(Entity::idFromString(
+                                  entity["ID"].as<std::string>())));
         else
             // Let Entity class create an ID if there's no ID node
             deserializeEntity(entity, scene->_entities.create());
@@ -151,6 +158,7 @@ void Serializer::deserializeEntity(YAML::Node &node, Entity &entity) {
         if (n["Flip"]) s.flip = n["Flip"].as<Vector<bool>>();
         if (n["FramesNumber"]) s.framesNumber = n["FramesNumber"].as<VectorI>();
         if (n["Frame"]) s.frame = n["Frame"].as<int>();
+        if (n["Depth"]) s.depth = n["Depth"].as<int>();
         if (n["RegionEnabled"]) s.regionEnabled = n["RegionEnabled"].as<bool>();
         if (n["Region"]) s.region = n["Region"].as<SDL_Rect>();
     }
@@ -193,7 +201,7 @@ void Serializer::serializeEntity(YAML::Emitter &out, Entity &entity) {
         out << YAML::Key << "TagComponent" << YAML::Value;
         out << YAML::BeginMap;
         out << YAML::Key << "Tag" << YAML::Value
-            << entity.get<Component::tag>().content;
+            << entity.get<Component::tag>().str();
         out << YAML::EndMap;
     }
 
@@ -217,6 +225,7 @@ void Serializer::serializeEntity(YAML::Emitter &out, Entity &entity) {
         out << YAML::Key << "Flip" << YAML::Value << s.flip;
         out << YAML::Key << "FramesNumber" << YAML::Value << s.framesNumber;
         out << YAML::Key << "Frame" << YAML::Value << s.frame;
+        out << YAML::Key << "Depth" << YAML::Value << s.depth;
         out << YAML::Key << "RegionEnabled" << YAML::Value << s.regionEnabled;
         out << YAML::Key << "Region" << YAML::Value << s.region;
         out << YAML::EndMap;
@@ -0,0 +1,163 @@
+#include "atlas.h"
+
+#include <SDL_image.h>
+
+#include <algorithm>
+
+#include "../logger/logger.h"
+#include "../renderer/renderer.h"
+
+TextureAtlas::~TextureAtlas() {
+    for (auto& [_, surface] : _pending) SDL_FreeSurface(surface);
+}
+
+std::string TextureAtlas::_key(const std::string& file) {
+    return fs::path(file).lexically_normal().generic_string();
+}
+
+bool TextureAtlas::add(const Path& filePath) {
+    return _add(std::string(filePath));
+}
+
+bool TextureAtlas::_add(const std::string& file) {
+    auto surface = IMG_Load(file.c_str());
+    if (!surface) {
+        Logger::error("Atlas") << "Failed to load '" << file << "'";
+        Logger::endline();
+
+        return false;
+    }
+
+    if (surface->w + PADDING > PAGE_SIZE || surface->h + PADDING > PAGE_SIZE) {
+        Logger::warn("Atlas")
+            << file << " is larger than an atlas page, it won't be packed";
+        Logger::endline();
+
+        SDL_FreeSurface(surface);
+        return false;
+    }
+
+    _pending.emplace_back(_key(file), surface);
+    return true;
+}
+
+std::size_t TextureAtlas::addDirectory(const Path& directory) {
+    static const std::vector<std::string> extensions = {
+        ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif"};
+
+    std::size_t count = 0;
+    for (auto& entry :
+         fs::recursive_directory_iterator(fs::path(directory))) {
+        if (!entry.is_regular_file()) continue;
+
+        auto extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       ::tolower);
+        if (std::find(extensions.begin(), extensions.end(), extension) ==
+            extensions.end())
+            continue;
+
+        count += _add(entry.path().string());
+    }
+
+    return count;
+}
+
+void TextureAtlas::build() {
+    if (_pending.empty()) return;
+
+    // tallest first packs noticeably tighter with a skyline
+    std::sort(_pending.begin(), _pending.end(), [](auto& a, auto& b) {
+        if (a.second->h != b.second->h) return a.second->h > b.second->h;
+        return a.second->w > b.second->w;
+    });
+
+    struct Page {
+        SkylinePacker packer;
+        SDL_Surface* surface;
+        std::vector<std::pair<std::string, SDL_Rect>> regions;
+    };
+    std::vector<Page> pages;
+
+    for (auto& [file, image] : _pending) {
+        SDL_Point position;
+        Page* page = nullptr;
+
+        for (auto& p : pages)
+            if (p.packer.pack(image->w + PADDING, image->h + PADDING,
+                              position)) {
+                page = &p;
+                break;
+            }
+
+        if (!page) {
+            pages.push_back({SkylinePacker(PAGE_SIZE, PAGE_SIZE),
+                             SDL_CreateRGBSurfaceWithFormat(
+                                 0, PAGE_SIZE, PAGE_SIZE, 32,
+                                 SDL_PIXELFORMAT_RGBA32),
+                             {}});
+            page = &pages.back();
+            page->packer.pack(image->w + PADDING, image->h + PADDING,
+                              position);
+        }
+
+        // copy pixels as they are, alpha included
+        SDL_Rect rect = {position.x, position.y, image->w, image->h};
+        SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(image, NULL, page->surface, &rect);
+        SDL_FreeSurface(image);
+
+        page->regions.emplace_back(file, rect);
+    }
+    _pending.clear();
+
+    auto renderer = RenderManager::Get()->renderer;
+    for (auto& page : pages) {
+        auto texture = SDL_CreateTextureFromSurface(renderer, page.surface);
+        SDL_FreeSurface(page.surface);
+
+        if (!texture) {
+            Logger::error("Atlas") << "Failed to create page texture";
+            Logger::endline();
+
+            continue;
+        }
+
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        _pages.push_back(texture);
+        for (auto& [file, rect] : page.regions)
+            _regions[file] = {texture, rect};
+    }
+
+    Logger::info("Atlas") << _regions.size() << " images packed into "
+                          << _pages.size() << " page(s)";
+    Logger::endline();
+}
+
+void TextureAtlas::addPage(
+    SDL_Texture* page,
+    const std::vector<std::pair<std::string, SDL_Rect>>& regions) {
+    _pages.push_back(page);
+    for (auto& [file, rect] : regions) _regions[_key(file)] = {page, rect};
+}
+
+void TextureAtlas::clear() {
+    for (auto page : _pages) SDL_DestroyTexture(page);
+    _pages.clear();
+    _regions.clear();
+}
+
+bool TextureAtlas::find(const std::string& file, Region& region) const {
+    if (_regions.empty()) return false;
+
+    auto it = _regions.find(_key(file));
+    if (it == _regions.end()) return false;
+
+    region = it->second;
+    return true;
+}
+
+std::size_t TextureAtlas::pageCount() const { return _pages.size(); }
+
+// static
+std::shared_ptr<TextureAtlas> TextureAtlas::Get() { return createInstance(); }
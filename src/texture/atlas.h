@@ -0,0 +1,81 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Texture atlas : pack many images into a few large textures
+ */
+
+#pragma once
+
+#include <SDL.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../manager/manager.h"
+#include "../path/path.h"
+#include "packer.h"
+
+/**
+ * Images added to the atlas are packed into pages on build().
+ * Texture::load then references the page region of a packed file
+ * instead of creating its own SDL_Texture, so sprites using different
+ * files can still be batched together.
+ *
+ * Build the atlas before loading the textures it should cover.
+ */
+class TextureAtlas : Manager<TextureAtlas> {
+   public:
+    struct Region {
+        SDL_Texture* texture;
+        SDL_Rect rect;
+    };
+
+    // pages are square textures of this size
+    static const int PAGE_SIZE = 2048;
+
+    // space left between packed images to avoid filtering bleed
+    static const int PADDING = 1;
+
+    static std::shared_ptr<TextureAtlas> Get();
+
+    // queue an image file for packing
+    bool add(const Path&);
+
+    // queue every image of a directory, recursively
+    // return number of images added
+    std::size_t addDirectory(const Path&);
+
+    // pack queued images into new pages
+    void build();
+
+    // register a page packed beforehand, e.g. by ecs-cook
+    void addPage(SDL_Texture*,
+                 const std::vector<std::pair<std::string, SDL_Rect>>& regions);
+
+    // destroy pages, textures referencing them become invalid
+    void clear();
+
+    // look for the region of a packed file
+    bool find(const std::string& file, Region&) const;
+
+    std::size_t pageCount() const;
+
+   private:
+    std::vector<std::pair<std::string, SDL_Surface*>> _pending;
+    std::vector<SDL_Texture*> _pages;
+    std::unordered_map<std::string, Region> _regions;
+
+    TextureAtlas() = default;
+    // pages belong to the renderer and are released with it
+    ~TextureAtlas();
+
+    static std::string _key(const std::string& file);
+
+    // file already resolved against the config path
+    bool _add(const std::string& file);
+
+    friend class Manager<TextureAtlas>;
+};
@@ -0,0 +1,74 @@
+#include "packer.h"
+
+#include <algorithm>
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : _width(width), _height(height) {
+    clear();
+}
+
+void SkylinePacker::clear() { _skyline = {{0, 0, _width}}; }
+
+int SkylinePacker::_fit(std::size_t index, int width, int height) const {
+    auto x = _skyline[index].x;
+    if (x + width > _width) return -1;
+
+    // segments always cover the whole width
+    int y = 0;
+    for (auto i = index; width > 0; width -= _skyline[i++].width) {
+        y = std::max(y, _skyline[i].y);
+        if (y + height > _height) return -1;
+    }
+
+    return y;
+}
+
+bool SkylinePacker::pack(int width, int height, SDL_Point& position) {
+    std::size_t best = _skyline.size();
+    int bestTop = _height + 1, bestWidth = _width + 1;
+
+    for (std::size_t i = 0; i < _skyline.size(); ++i) {
+        auto y = _fit(i, width, height);
+        if (y < 0) continue;
+
+        // lowest top first, then the narrowest segment
+        if (y + height < bestTop ||
+            (y + height == bestTop && _skyline[i].width < bestWidth)) {
+            best = i;
+            bestTop = y + height;
+            bestWidth = _skyline[i].width;
+        }
+    }
+
+    if (best == _skyline.size()) return false;
+
+    position = {_skyline[best].x, bestTop - height};
+    _skyline.insert(_skyline.begin() + best, {position.x, bestTop, width});
+
+    // shrink segments now covered by the new one
+    for (auto i = best + 1; i < _skyline.size();) {
+        auto& previous = _skyline[i - 1];
+        auto& segment = _skyline[i];
+        auto overlap = previous.x + previous.width - segment.x;
+        if (overlap <= 0) break;
+
+        if (overlap >= segment.width) {
+            _skyline.erase(_skyline.begin() + i);
+            continue;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        break;
+    }
+
+    // merge neighbours at the same height
+    for (std::size_t i = 1; i < _skyline.size();) {
+        if (_skyline[i - 1].y == _skyline[i].y) {
+            _skyline[i - 1].width += _skyline[i].width;
+            _skyline.erase(_skyline.begin() + i);
+        } else
+            ++i;
+    }
+
+    return true;
+}
@@ -0,0 +1,39 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Rectangle packing used to build texture atlases
+ */
+
+#pragma once
+
+#include <SDL.h>
+
+#include <vector>
+
+/**
+ * Skyline bottom-left rectangle packer
+ *
+ * Keeps the top edge of packed rectangles as a list of horizontal
+ * segments and places each rectangle where its top is the lowest.
+ */
+class SkylinePacker {
+   public:
+    SkylinePacker(int width, int height);
+
+    // find room for a width x height rectangle,
+    // false if it does not fit anymore
+    bool pack(int width, int height, SDL_Point& position);
+
+    void clear();
+
+   private:
+    struct Segment {
+        int x, y, width;
+    };
+
+    int _width, _height;
+    std::vector<Segment> _skyline;
+
+    // y position of a rectangle laid on the index-th segment, -1 if none
+    int _fit(std::size_t index, int width, int height) const;
+};
@@ -3,14 +3,45 @@
 #include <SDL_image.h>
 
 #include "../logger/logger.h"
+#include "../pack/assets.h"
 #include "../renderer/renderer.h"
+#include "atlas.h"
 
 std::map<std::string, SDL_Texture *> Texture::_loadedTextures;
 
 Texture::Texture(const Path &file) { load(file); }
 
+Texture::Texture(Texture &&other) noexcept
+    : _file(std::move(other._file)),
+      _texture(other._texture),
+      _region(other._region),
+      _packed(other._packed) {
+    other._file.clear();
+    other._texture = nullptr;
+    other._packed = false;
+}
+
+Texture &Texture::operator=(Texture &&other) noexcept {
+    if (this != &other) {
+        if (_texture && !_packed) {
+            _loadedTextures.erase(_file);
+            SDL_DestroyTexture(_texture);
+        }
+
+        _file = std::move(other._file);
+        _texture = other._texture;
+        _region = other._region;
+        _packed = other._packed;
+
+        other._file.clear();
+        other._texture = nullptr;
+        other._packed = false;
+    }
+    return *this;
+}
+
 Texture::~Texture() {
-    if (_texture) {
+    if (_texture && !_packed) {
         _loadedTextures.erase(_file);
         SDL_DestroyTexture(_texture);
     }
@@ -22,14 +53,19 @@ void Texture::unload() {
 }
 
 bool Texture::load(const Path &filePath) {
-    if (!filePath.exists()) {
-        Logger::error("Texture") << filePath << " does not exist";
-        Logger::endline();
+    std::string file(filePath);
 
-        return false;
-    }
+    // packed images share their atlas page
+    if (TextureAtlas::Region region;
+        TextureAtlas::Get()->find(file, region)) {
+        _file = file;
+        _texture = region.texture;
+        _region = region.rect;
+        _packed = true;
 
-    std::string file(filePath);
+        return true;
+    }
+    _packed = false;
 
     if (_loadedTextures[file]) {
         _file = file;
@@ -38,8 +74,18 @@ bool Texture::load(const Path &filePath) {
         Logger::info("Texture") << file << " : texture loaded from cache";
         Logger::endline();
     } else {
-        _texture =
-            IMG_LoadTexture(RenderManager::Get()->renderer, file.c_str());
+        // pre-decoded pixels, the source file may not be shipped
+        if (!AssetPack::Get()->image(file, _texture)) {
+            if (!filePath.exists()) {
+                Logger::error("Texture") << filePath << " does not exist";
+                Logger::endline();
+
+                return false;
+            }
+
+            _texture =
+                IMG_LoadTexture(RenderManager::Get()->renderer, file.c_str());
+        }
 
         if (_texture) {
             _file = file;
@@ -60,14 +106,24 @@ std::string Texture::getName() const { return _file; }
 SDL_Texture *Texture::get() const { return _texture; }
 
 VectorI Texture::getSize() const {
+    if (_packed) return VectorI(_region.w, _region.h);
+
     VectorI ret;
     SDL_QueryTexture(_texture, NULL, NULL, &ret.x, &ret.y);
     return ret;
 }
 
+SDL_Rect Texture::getRegion() const {
+    if (_packed) return _region;
+
+    auto s = getSize();
+    return {0, 0, s.x, s.y};
+}
+
 void Texture::set(SDL_Texture *texture) {
     _file = "";
     _texture = texture;
+    _packed = false;
 }
 
 Texture::operator bool() const { return _texture != NULL; }
@@ -98,6 +154,8 @@ void Texture::draw(const SDL_Rect &src, const VectorI &dst,
                    const Vector<bool> &flip, const VectorF &scale) {
     SDL_Rect d = {dst.x, dst.y, int(src.w * scale.x), int(src.h * scale.y)};
     SDL_Point c = {center.x, center.y};
-    SDL_RenderCopyEx(RenderManager::Get()->renderer, _texture, &src, &d,
+    SDL_Rect s = src;
+    if (_packed) s.x += _region.x, s.y += _region.y;
+    SDL_RenderCopyEx(RenderManager::Get()->renderer, _texture, &s, &d,
                      rotation, &c, SDL_RendererFlip((flip.y << 1) | flip.x));
 }
\ No newline at end of file
@@ -24,12 +24,23 @@ class Texture {
     std::string _file = "";
     SDL_Texture* _texture = nullptr;
 
+    // area used inside an atlas page, the page is not owned
+    SDL_Rect _region = {0, 0, 0, 0};
+    bool _packed = false;
+
     static std::map<std::string, SDL_Texture*> _loadedTextures;
 
    public:
     Texture() = default;
     Texture(const Path&);
 
+    // a texture owns its SDL_Texture, ownership is only transferable
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    Texture(Texture&&) noexcept;
+    Texture& operator=(Texture&&) noexcept;
+
     ~Texture();
 
     // Make sure to unload left textures
@@ -46,6 +57,10 @@ class Texture {
     // Return texture size
     VectorI getSize() const;
 
+    // Area of get() covered by this texture,
+    // the whole texture unless it comes from an atlas
+    SDL_Rect getRegion() const;
+
     // Set texture content
     // This method reset the texture's initial name
     void set(SDL_Texture*);
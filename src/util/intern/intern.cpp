@@ -0,0 +1,56 @@
+#include "intern.h"
+
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+struct Table {
+    std::mutex mutex;
+
+    // deque keeps strings in place, views below point into it
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, InternedString::ID> ids;
+};
+
+Table& table() {
+    static Table instance;
+    return instance;
+}
+
+}  // namespace
+
+InternedString::InternedString(const std::string& str) {
+    auto& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+
+    if (auto it = t.ids.find(str); it != t.ids.end()) {
+        _id = it->second;
+        return;
+    }
+
+    _id = ID(t.strings.size());
+    t.strings.push_back(str);
+    t.ids.emplace(t.strings.back(), _id);
+}
+
+// static
+InternedString InternedString::Find(const std::string& str) {
+    auto& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+
+    InternedString ret;
+    if (auto it = t.ids.find(str); it != t.ids.end()) ret._id = it->second;
+    return ret;
+}
+
+const std::string& InternedString::str() const {
+    static const std::string empty;
+    if (!valid()) return empty;
+
+    auto& t = table();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    return t.strings[_id];
+}
@@ -0,0 +1,60 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * String interning : equal strings share one copy and compare as integers
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * Handle to a string stored once for the whole application
+ *
+ * InternedString a("player"), b("player");
+ * a == b;  // integer comparison
+ * a.str(); // "player"
+ *
+ * The table only grows, interned strings live until the application exits.
+ */
+class InternedString {
+   public:
+    using ID = std::uint32_t;
+    static constexpr ID INVALID = ~ID(0);
+
+    InternedString() = default;
+
+    // intern str if it wasn't yet
+    explicit InternedString(const std::string& str);
+
+    // handle of str if already interned, invalid otherwise
+    static InternedString Find(const std::string& str);
+
+    // empty string if invalid
+    const std::string& str() const;
+
+    ID id() const { return _id; }
+
+    bool valid() const { return _id != INVALID; }
+
+    bool operator==(const InternedString& other) const {
+        return _id == other._id;
+    }
+    bool operator!=(const InternedString& other) const {
+        return _id != other._id;
+    }
+
+   private:
+    ID _id = INVALID;
+};
+
+namespace std {
+template <>
+struct hash<InternedString> {
+    std::size_t operator()(const InternedString& str) const {
+        return std::hash<InternedString::ID>()(str.id());
+    }
+};
+}  // namespace std
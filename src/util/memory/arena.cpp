@@ -0,0 +1,58 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+Arena::Arena(std::size_t blockSize) : _blockSize(blockSize) {}
+
+Arena::~Arena() {
+    reset();
+    for (auto& block : _blocks)
+        ::operator delete(block.data, std::align_val_t(alignof(std::max_align_t)));
+}
+
+void* Arena::allocate(std::size_t size, std::size_t alignment) {
+    while (_current < _blocks.size()) {
+        auto& block = _blocks[_current];
+        auto address = reinterpret_cast<std::uintptr_t>(block.data) + _offset;
+        auto padding = (alignment - address % alignment) % alignment;
+
+        if (_offset + padding + size <= block.size) {
+            _offset += padding + size;
+            _used += padding + size;
+            _peak = std::max(_peak, _used);
+            return block.data + _offset - size;
+        }
+
+        // keep looking in blocks kept from previous cycles
+        ++_current;
+        _offset = 0;
+    }
+
+    // oversized allocations get their own block
+    auto blockSize = std::max(_blockSize, size + alignment);
+    _blocks.push_back(
+        {static_cast<std::byte*>(::operator new(
+             blockSize, std::align_val_t(alignof(std::max_align_t)))),
+         blockSize});
+    _current = _blocks.size() - 1;
+    _offset = 0;
+
+    return allocate(size, alignment);
+}
+
+void Arena::reset() {
+    for (auto it = _destructors.rbegin(); it != _destructors.rend(); ++it)
+        it->destroy(it->object);
+    _destructors.clear();
+
+    _current = 0;
+    _offset = 0;
+    _used = 0;
+}
+
+Arena::Stats Arena::stats() const {
+    std::size_t capacity = 0;
+    for (auto& block : _blocks) capacity += block.size;
+    return {_used, capacity, _peak};
+}
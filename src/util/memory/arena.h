@@ -0,0 +1,80 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Bump allocator released all at once
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Allocations are carved from large blocks and released together with
+ * reset(), which also destroys objects built with create().
+ * Blocks are kept for the next cycle, e.g. the next frame.
+ *
+ * Not thread safe.
+ */
+class Arena {
+   public:
+    struct Stats {
+        // bytes handed out since last reset
+        std::size_t used;
+
+        // bytes allocated from the heap
+        std::size_t capacity;
+
+        // highest usage between two resets
+        std::size_t peak;
+    };
+
+    explicit Arena(std::size_t blockSize = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    // object destroyed on reset
+    template <typename T, typename... TArgs>
+    T* create(TArgs&&... args) {
+        auto ret =
+            new (allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+        if constexpr (!std::is_trivially_destructible<T>::value)
+            _destructors.push_back(
+                {ret, [](void* object) { static_cast<T*>(object)->~T(); }});
+        return ret;
+    }
+
+    // destroy created objects and make every block available again
+    void reset();
+
+    Stats stats() const;
+
+   private:
+    struct Block {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    std::size_t _blockSize;
+
+    std::vector<Block> _blocks;
+    std::size_t _current = 0;
+    std::size_t _offset = 0;
+
+    std::vector<Destructor> _destructors;
+
+    std::size_t _used = 0;
+    std::size_t _peak = 0;
+};
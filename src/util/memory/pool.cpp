@@ -0,0 +1,75 @@
+#include "pool.h"
+
+#include <algorithm>
+
+namespace {
+
+std::vector<PoolAllocator*>& pools() {
+    static std::vector<PoolAllocator*> instance;
+    return instance;
+}
+
+}  // namespace
+
+PoolAllocator::PoolAllocator(const std::string& name, std::size_t blockSize,
+                             std::size_t alignment, std::size_t blocksPerChunk)
+    : _name(name),
+      _alignment(std::max(alignment, alignof(Block))),
+      _blocksPerChunk(std::max<std::size_t>(blocksPerChunk, 1)) {
+    // a free block stores the link to the next one
+    blockSize = std::max(blockSize, sizeof(Block));
+    _blockSize = (blockSize + _alignment - 1) / _alignment * _alignment;
+
+    pools().push_back(this);
+}
+
+PoolAllocator::~PoolAllocator() {
+    auto& list = pools();
+    list.erase(std::remove(list.begin(), list.end(), this), list.end());
+
+    for (auto chunk : _chunks)
+        ::operator delete(chunk, std::align_val_t(_alignment));
+}
+
+void* PoolAllocator::allocate() {
+    if (!_free) _grow();
+
+    auto block = _free;
+    _free = block->next;
+
+    _peak = std::max(_peak, ++_used);
+    return block;
+}
+
+void PoolAllocator::deallocate(void* memory) {
+    if (!memory) return;
+
+    auto block = static_cast<Block*>(memory);
+    block->next = _free;
+    _free = block;
+    --_used;
+}
+
+PoolAllocator::Stats PoolAllocator::stats() const {
+    return {_name, _blockSize, _chunks.size() * _blocksPerChunk, _used, _peak};
+}
+
+// static
+std::vector<PoolAllocator::Stats> PoolAllocator::Statistics() {
+    std::vector<Stats> ret;
+    for (auto pool : pools()) ret.push_back(pool->stats());
+    return ret;
+}
+
+void PoolAllocator::_grow() {
+    auto chunk = static_cast<std::byte*>(::operator new(
+        _blockSize * _blocksPerChunk, std::align_val_t(_alignment)));
+    _chunks.push_back(chunk);
+
+    // thread the new blocks in address order
+    for (std::size_t i = _blocksPerChunk; i-- > 0;) {
+        auto block = reinterpret_cast<Block*>(chunk + i * _blockSize);
+        block->next = _free;
+        _free = block;
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Fixed-size block allocators
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+/**
+ * Hands out blocks of one size from chunks allocated ahead, freed blocks are
+ * reused before growing. Chunks are kept until the allocator is destroyed.
+ *
+ * Not thread safe, like entity and component management.
+ */
+class PoolAllocator {
+   public:
+    struct Stats {
+        std::string name;
+        std::size_t blockSize;
+
+        // blocks allocated from the heap
+        std::size_t capacity;
+
+        // blocks in use
+        std::size_t used;
+
+        // highest number of blocks in use
+        std::size_t peak;
+    };
+
+    PoolAllocator(const std::string& name, std::size_t blockSize,
+                  std::size_t alignment, std::size_t blocksPerChunk = 256);
+    ~PoolAllocator();
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    void* allocate();
+    void deallocate(void*);
+
+    Stats stats() const;
+
+    // utilization of every living pool
+    static std::vector<Stats> Statistics();
+
+   private:
+    struct Block {
+        Block* next;
+    };
+
+    void _grow();
+
+    std::string _name;
+    std::size_t _blockSize;
+    std::size_t _alignment;
+    std::size_t _blocksPerChunk;
+
+    std::vector<void*> _chunks;
+    Block* _free = nullptr;
+
+    std::size_t _used = 0;
+    std::size_t _peak = 0;
+};
+
+// Pool of objects of type T
+template <typename T>
+class Pool {
+   public:
+    template <typename... TArgs>
+    static T* create(TArgs&&... args) {
+        auto memory = allocator().allocate();
+        try {
+            return new (memory) T(std::forward<TArgs>(args)...);
+        } catch (...) {
+            allocator().deallocate(memory);
+            throw;
+        }
+    }
+
+    static void destroy(T* object) {
+        if (!object) return;
+        object->~T();
+        allocator().deallocate(object);
+    }
+
+    static PoolAllocator& allocator() {
+        static PoolAllocator instance(typeid(T).name(), sizeof(T), alignof(T));
+        return instance;
+    }
+};
+
+// Deleter of objects created by Pool<T>, or by new when not pooled
+template <typename T>
+struct PoolDeleter {
+    bool pooled = true;
+
+    void operator()(T* object) const {
+        if (pooled)
+            Pool<T>::destroy(object);
+        else
+            delete object;
+    }
+};
@@ -0,0 +1,83 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * Lock-free multi-producer single-consumer queue
+ */
+
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+/**
+ * Unbounded linked queue (D. Vyukov's MPSC design)
+ *
+ * Any thread may push, a push is one atomic exchange. A single thread pops.
+ * An element whose push is still in progress is seen on a later pop.
+ *
+ * MPSCQueue<int> queue;
+ * queue.push(5);      // from any thread
+ * int value;
+ * queue.pop(value);   // from the consumer thread only
+ */
+template <typename T>
+class MPSCQueue {
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+   public:
+    MPSCQueue() {
+        auto stub = new Node;
+        _head.store(stub, std::memory_order_relaxed);
+        _tail = stub;
+    }
+
+    ~MPSCQueue() {
+        while (_tail) {
+            auto next = _tail->next.load(std::memory_order_relaxed);
+            delete _tail;
+            _tail = next;
+        }
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // thread safe
+    void push(T value) {
+        auto node = new Node;
+        node->value.emplace(std::move(value));
+
+        auto previous = _head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // consumer thread only, false if no element is available
+    bool pop(T& value) {
+        auto next = _tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+
+        // next becomes the stub
+        value = std::move(*next->value);
+        next->value.reset();
+
+        delete _tail;
+        _tail = next;
+        return true;
+    }
+
+    // consumer thread only
+    bool empty() const {
+        return !_tail->next.load(std::memory_order_acquire);
+    }
+
+   private:
+    // last pushed node, producers side
+    std::atomic<Node*> _head;
+
+    // stub preceding the next element, consumer side
+    Node* _tail;
+};
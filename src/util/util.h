@@ -10,4 +10,8 @@
 #include "./blur/blur.h"
 #include "./geometry/vector.h"
 #include "./geometry/visibility.h"
-#include "./observable/observable.h"
\ No newline at end of file
+#include "./intern/intern.h"
+#include "./memory/arena.h"
+#include "./memory/pool.h"
+#include "./observable/observable.h"
+#include "./queue/mpsc.h"
\ No newline at end of file
@@ -0,0 +1,200 @@
+/**
+ * Producer throughput of EventManager::post under contention
+ *
+ * N producers post events while the main thread handles them, as worker
+ * threads would. Posting with an interned name, which doesn't lock, is
+ * compared with posting with a string, which interns it on every call, and
+ * with a mutex guarded std::queue drained into EventManager::emit.
+ * Push rate is measured until the last producer is done, the time the
+ * consumer then needs to catch up is reported apart.
+ *
+ * EventManager::emit and handle are then measured on the main thread.
+ *
+ * usage : EventQueueBenchmark [events per producer]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "application/application.h"
+#include "event/event.h"
+#include "util/intern/intern.h"
+
+// not an application, but the library expects the hook to be defined
+RUN_APPLICATION()
+
+// payload of the size of a small event record
+struct Payload {
+    int producer;
+    int sequence;
+    double data[4];
+};
+
+const std::string NAME = "benchmark";
+
+// producers post straight to the EventManager
+struct Posted {
+    InternedString name{NAME};
+
+    void push(Payload value) { EventManager::Get()->post(name, value); }
+
+    void drain() {}
+};
+
+// producers intern the name on every post
+struct PostedByString {
+    void push(Payload value) { EventManager::Get()->post(NAME, value); }
+
+    void drain() {}
+};
+
+// producers lock a queue the main thread empties into the EventManager
+class Locked {
+    std::mutex _mutex;
+    std::queue<Payload> _queue;
+
+   public:
+    void push(Payload value) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push(value);
+    }
+
+    void drain() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (; !_queue.empty(); _queue.pop())
+            EventManager::Get()->emit(NAME).attach<Payload>(_queue.front());
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    // million events per second pushed by all producers together
+    double throughput;
+
+    // milliseconds left to drain once every producer is done
+    double drain;
+};
+
+template <typename Producer>
+Result run(int producers, int count) {
+    auto events = EventManager::Get();
+
+    Producer producer;
+    std::atomic<bool> start{false};
+
+    // events of one producer arrive in order
+    long long received = 0, expected = (long long)producers * count;
+    std::vector<int> last(producers, -1);
+    EventListner listener;
+    listener.listen(NAME, [&](Event& event) {
+        auto& value = event.get<Payload>();
+        if (value.sequence != last[value.producer] + 1) {
+            std::fprintf(stderr, "out of order event\n");
+            std::exit(1);
+        }
+        last[value.producer] = value.sequence;
+        ++received;
+    });
+
+    // time each producer pushed its last event
+    std::vector<Clock::time_point> finished(producers);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&, p] {
+            while (!start) std::this_thread::yield();
+
+            for (int i = 0; i < count; ++i) producer.push({p, i, {}});
+            finished[p] = Clock::now();
+        });
+
+    auto begin = Clock::now();
+    start = true;
+
+    // consumer : handle until every event was delivered
+    while (received < expected) {
+        producer.drain();
+        events->handle();
+    }
+
+    auto drained = Clock::now();
+
+    for (auto& thread : threads) thread.join();
+    auto pushed = *std::max_element(finished.begin(), finished.end());
+
+    auto pushing = std::chrono::duration<double>(pushed - begin).count();
+    auto draining = std::chrono::duration<double, std::milli>(
+                        std::max(drained, pushed) - pushed)
+                        .count();
+
+    return {expected / pushing / 1e6, draining};
+}
+
+// emit count events then dispatch them, on the main thread
+void runEventManager(int count, Coalescing policy, const char* label) {
+    auto events = EventManager::Get();
+    events->coalesce(NAME, policy);
+
+    long long received = 0;
+    EventListner listener;
+    listener.listen(NAME, [&](Event& event) {
+        received += event.get<Payload>().sequence;
+    });
+
+    auto begin = Clock::now();
+    for (int i = 0; i < count; ++i)
+        events->emit(NAME).attach<Payload>(Payload{0, i, {}});
+    auto emitted = Clock::now();
+    events->handle();
+    auto handled = Clock::now();
+
+    auto emitting = std::chrono::duration<double>(emitted - begin).count();
+    auto handling =
+        std::chrono::duration<double, std::milli>(handled - emitted).count();
+
+    std::printf("%12s %11.2f M/s %11.2f ms %12lld\n", label,
+                count / emitting / 1e6, handling, received);
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int maxProducers = std::max(2u, std::thread::hardware_concurrency());
+
+    // created before the producers start, as the Application does
+    auto events = EventManager::Get();
+    events->coalesce(NAME, Coalescing::KEEP_ALL);
+
+    std::printf("%d events per producer\n", count);
+    std::printf("%10s %16s %12s %16s %12s %16s %12s\n", "producers",
+                "post(interned)", "drain", "post(string)", "drain",
+                "mutex+queue", "drain");
+
+    for (int producers = 1; producers <= maxProducers; producers *= 2) {
+        auto interned = run<Posted>(producers, count);
+        auto byString = run<PostedByString>(producers, count);
+        auto locked = run<Locked>(producers, count);
+
+        std::printf(
+            "%10d %11.2f M/s %9.2f ms %11.2f M/s %9.2f ms %11.2f M/s %9.2f "
+            "ms\n",
+            producers, interned.throughput, interned.drain, byString.throughput,
+            byString.drain, locked.throughput, locked.drain);
+    }
+
+    std::printf("\nEventManager, %d events\n", count);
+    std::printf("%12s %16s %14s %12s\n", "policy", "emit", "handle",
+                "checksum");
+    runEventManager(count, Coalescing::KEEP_ALL, "KEEP_ALL");
+    runEventManager(count, Coalescing::KEEP_LATEST, "KEEP_LATEST");
+
+    return 0;
+}
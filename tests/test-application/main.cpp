@@ -47,10 +47,10 @@ class Mob : public Script {
 class FollowMouseBehavior : public Script {
    public:
     FollowMouseBehavior() {
-        event.listen(Input.MOUSE_MOTION, [&](Entity& entity) {
+        event.listen(Input.MOUSE_MOTION, [&](Event& event) {
             auto& position = get<Component::transform>().position;
-            auto event = entity.get<SDL_MouseMotionEvent>();
-            position.set(event.x, event.y);
+            auto& motion = event.get<SDL_MouseMotionEvent>();
+            position.set(motion.x, motion.y);
         });
     }
 };
@@ -207,8 +207,7 @@ class WorldSystem : public ISystem {
             if (!entity) return false;
 
             if (entity->has<Component::tag>()) {
-                auto tag = entity->get<Component::tag>();
-                return tag.content == "main camera";
+                return entity->get<Component::tag>() == "main camera";
             }
 
             return false;
@@ -0,0 +1,232 @@
+/**
+ * @author acf-patrick (miharisoap@gmail.com)
+ *
+ * ecs-cook : preprocess an asset directory into a single pack
+ *
+ * usage : ecs-cook <asset-directory> [output] [--no-atlas]
+ *
+ * - images are decoded to RGBA32 and packed into atlas pages
+ * - scenes (.scn) and templates (.entt) are stored as binary YAML
+ * - Tiled maps (.json, .tmj) are stored as they are
+ *
+ * The output defaults to <asset-directory>/assets.pack, where the
+ * runtime looks for it.
+ */
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_image.h>
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "pack/pack.h"
+#include "serializer/binary.h"
+#include "texture/packer.h"
+
+namespace fs = std::filesystem;
+
+// same as TextureAtlas
+const int PAGE_SIZE = 2048;
+const int PADDING = 1;
+
+struct Image {
+    std::string name;
+    SDL_Surface* surface;
+};
+
+struct Page {
+    SkylinePacker packer = SkylinePacker(PAGE_SIZE, PAGE_SIZE);
+    std::vector<Uint32> pixels = std::vector<Uint32>(PAGE_SIZE * PAGE_SIZE);
+};
+
+std::string extensionOf(const fs::path& path) {
+    auto extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   ::tolower);
+    return extension;
+}
+
+// copy rows of a RGBA32 surface
+void blit(SDL_Surface* surface, Uint32* destination, int pitch) {
+    for (int y = 0; y < surface->h; ++y)
+        std::memcpy(destination + y * pitch,
+                    static_cast<char*>(surface->pixels) + y * surface->pitch,
+                    surface->w * 4);
+}
+
+bool cookImage(const fs::path& file, const std::string& name,
+               std::vector<Image>& images) {
+    auto loaded = IMG_Load(file.string().c_str());
+    if (!loaded) return false;
+
+    auto surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface) return false;
+
+    images.push_back({name, surface});
+    return true;
+}
+
+bool cookDocument(const fs::path& file, const std::string& name,
+                  PackWriter& pack) {
+    try {
+        auto data = BinaryYAML::encode(YAML::LoadFile(file.string()));
+        pack.add(Pack::Type::DOCUMENT, name, data.data(), data.size());
+    } catch (const YAML::Exception& e) {
+        std::cerr << name << " : " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool cookTilemap(const fs::path& file, const std::string& name,
+                 PackWriter& pack) {
+    std::ifstream in(file, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+
+    // JSON is valid YAML, only used to tell maps apart
+    try {
+        auto map = YAML::Load(data);
+        if (!map.IsMap() || !map["type"] ||
+            map["type"].as<std::string>() != "map")
+            return false;
+
+        // parsed from memory, external tilesets could not be resolved
+        for (auto tileset : map["tilesets"])
+            if (tileset["source"]) {
+                std::cerr << name << " : external tileset, left on disk"
+                          << std::endl;
+                return false;
+            }
+    } catch (const YAML::Exception&) {
+        return false;
+    }
+
+    pack.add(Pack::Type::TILEMAP, name, data.data(), data.size());
+    return true;
+}
+
+void packImages(std::vector<Image>& images, bool atlas, PackWriter& pack) {
+    std::vector<Page> pages;
+    std::vector<std::pair<std::string, Pack::Region>> regions;
+
+    // tallest first packs noticeably tighter with a skyline
+    std::sort(images.begin(), images.end(), [](auto& a, auto& b) {
+        if (a.surface->h != b.surface->h) return a.surface->h > b.surface->h;
+        return a.surface->w > b.surface->w;
+    });
+
+    for (auto& [name, surface] : images) {
+        auto w = surface->w, h = surface->h;
+
+        if (!atlas || w + PADDING > PAGE_SIZE || h + PADDING > PAGE_SIZE) {
+            std::vector<Uint32> pixels(w * h);
+            blit(surface, pixels.data(), w);
+            pack.addImage(Pack::Type::IMAGE, name, w, h, pixels.data());
+            continue;
+        }
+
+        SDL_Point position;
+        std::size_t index = 0;
+        while (index < pages.size() &&
+               !pages[index].packer.pack(w + PADDING, h + PADDING, position))
+            ++index;
+
+        if (index == pages.size()) {
+            pages.emplace_back();
+            pages.back().packer.pack(w + PADDING, h + PADDING, position);
+        }
+
+        blit(surface,
+             pages[index].pixels.data() + position.y * PAGE_SIZE + position.x,
+             PAGE_SIZE);
+        regions.push_back(
+            {name, {std::uint32_t(index), position.x, position.y, w, h}});
+    }
+
+    for (std::size_t i = 0; i < pages.size(); ++i)
+        pack.addImage(Pack::Type::ATLAS_PAGE, "@atlas/" + std::to_string(i),
+                      PAGE_SIZE, PAGE_SIZE, pages[i].pixels.data());
+
+    for (auto& [name, region] : regions)
+        pack.add(Pack::Type::REGION, name, &region, sizeof(region));
+
+    std::cout << images.size() << " images, " << pages.size()
+              << " atlas page(s)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args;
+    auto atlas = true;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--no-atlas")
+            atlas = false;
+        else
+            args.push_back(argv[i]);
+    }
+
+    if (args.empty() || args.size() > 2) {
+        std::cerr << "usage : ecs-cook <asset-directory> [output] [--no-atlas]"
+                  << std::endl;
+        return 1;
+    }
+
+    fs::path root(args[0]);
+    if (!fs::is_directory(root)) {
+        std::cerr << root << " is not a directory" << std::endl;
+        return 1;
+    }
+    auto output = args.size() > 1 ? fs::path(args[1]) : root / "assets.pack";
+
+    // sorted for reproducible packs
+    std::vector<fs::path> files;
+    std::error_code error;
+    for (auto& entry : fs::recursive_directory_iterator(root))
+        if (entry.is_regular_file() &&
+            !fs::equivalent(entry.path(), output, error))
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+
+    PackWriter pack;
+    std::vector<Image> images;
+
+    for (auto& file : files) {
+        // names relative to the cooked directory, as the runtime expects
+        auto name = file.lexically_relative(root).generic_string();
+        auto extension = extensionOf(file);
+        auto cooked = false;
+
+        if (extension == ".png" || extension == ".jpg" ||
+            extension == ".jpeg" || extension == ".bmp" ||
+            extension == ".tga" || extension == ".gif")
+            cooked = cookImage(file, name, images);
+        else if (extension == ".scn" || extension == ".entt")
+            cooked = cookDocument(file, name, pack);
+        else if (extension == ".json" || extension == ".tmj")
+            cooked = cookTilemap(file, name, pack);
+        else
+            continue;
+
+        if (!cooked) std::cerr << name << " : skipped" << std::endl;
+    }
+
+    packImages(images, atlas, pack);
+    for (auto& image : images) SDL_FreeSurface(image.surface);
+
+    if (!pack.write(output.string())) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << pack.size() << " entries written to " << output << std::endl;
+    return 0;
+}